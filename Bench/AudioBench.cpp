@@ -0,0 +1,638 @@
+#include "../Source/Audio/BeatTracker.h"
+#include "../Source/Audio/FFTProcessor.h"
+#include "../Source/Audio/FrequencyAnalyzer.h"
+#include "../Source/Audio/PCMConvert.h"
+#include "../Source/Audio/Resampler.h"
+#include "../Source/Audio/STFTProcessor.h"
+#include "../Source/Audio/SlidingDFT.h"
+#include "../Source/Audio/Spectrogram.h"
+#include "../Source/Utils/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+// Throughput of the audio hot paths on synthetic input, so the figures quoted for the
+// PCM kernels, the resampler, the FFT processor, the spectrogram, the sliding DFT and the
+// beat tracker can be reproduced. Run a Release build; pass a section name (pcm, resample,
+// fft, spectrogram, sliding, beat) to run only that.
+// Every figure is the best of BenchRuns timed runs.
+
+namespace
+{
+    const int BenchRuns = 5;
+
+    // Heap allocations made by anything in this process, for the allocation-free paths
+    std::atomic<uint64_t> s_allocations(0);
+
+    using Clock = std::chrono::steady_clock;
+
+    double GetSeconds(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    std::vector<SIMDLevel> GetLevels()
+    {
+        std::vector<SIMDLevel> levels;
+        for (SIMDLevel level : { SIMDLevel::Scalar, SIMDLevel::SSE2, SIMDLevel::AVX2 })
+        {
+            if (level <= PCMConvert::GetSupportedLevel())
+                levels.push_back(level);
+        }
+        return levels;
+    }
+
+    // A background FFTW_MEASURE would share the cores with the timed loop
+    void WaitUntilMeasured(const FFTProcessor& fft)
+    {
+        while (!fft.IsPlanMeasured())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    void FillNoise(uint32_t seed, float* samples, size_t count)
+    {
+        uint32_t state = seed;
+        for (size_t i = 0; i < count; ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            samples[i] = static_cast<float>(state >> 8) / 16777216.0f - 0.5f;
+        }
+    }
+
+    // 3 minutes of 44.1 kHz stereo in each integer format, converted to mono float
+    void BenchPCMConvert()
+    {
+        const size_t frameCount = 44100 * 180;
+        const int channels = 2;
+        const SampleFormat formats[] = { SampleFormat::Int16, SampleFormat::Int24, SampleFormat::Int32 };
+        const char* names[] = { "16-bit", "24-bit", "32-bit" };
+
+        std::vector<uint8_t> source;
+        std::vector<float> output(frameCount);
+
+        std::cout << "PCM to mono float, 3 min 44.1 kHz stereo (Msamples/s)" << std::endl;
+        for (int f = 0; f < 3; ++f)
+        {
+            const size_t bytes = frameCount * channels * PCMConvert::GetBytesPerSample(formats[f]);
+            source.resize(bytes);
+            uint32_t state = 12345u;
+            for (uint8_t& byte : source)
+            {
+                state = state * 1664525u + 1013904223u;
+                byte = static_cast<uint8_t>(state >> 24);
+            }
+
+            std::cout << "  " << names[f];
+            for (SIMDLevel level : GetLevels())
+            {
+                PCMConvert::SetActiveLevel(level);
+                PCMConvertFunc kernel = PCMConvert::SelectKernel(formats[f], channels);
+
+                double best = 1e30;
+                for (int run = 0; run < BenchRuns; ++run)
+                {
+                    Clock::time_point start = Clock::now();
+                    kernel(source.data(), frameCount, output.data(), channels);
+                    best = std::min(best, GetSeconds(start));
+                }
+                std::cout << "  " << PCMConvert::GetLevelName(level) << " " << std::fixed << std::setprecision(0)
+                    << frameCount * channels / best / 1e6;
+            }
+            std::cout << std::endl;
+        }
+        PCMConvert::SetActiveLevel(PCMConvert::GetSupportedLevel());
+    }
+
+    // 44.1 -> 48 kHz in 735-sample chunks (one 60 Hz frame), as the live path feeds it
+    void BenchResampler()
+    {
+        const size_t inputCount = 44100 * 60;
+        const size_t chunk = 735;
+        const ResampleQuality qualities[] = { ResampleQuality::Fast, ResampleQuality::Balanced, ResampleQuality::High };
+        const char* names[] = { "Fast", "Balanced", "High" };
+
+        std::vector<float> input(inputCount);
+        FillNoise(1u, input.data(), inputCount);
+
+        std::cout << "Resampler 44.1 -> 48 kHz, 735-sample chunks (Msamples/s in)" << std::endl;
+        for (int q = 0; q < 3; ++q)
+        {
+            Resampler resampler;
+            resampler.Initialize(44100, 48000, qualities[q]);
+            std::vector<float> output(resampler.GetMaxOutput(chunk));
+
+            std::cout << "  " << std::left << std::setw(9) << names[q] << std::right;
+            for (SIMDLevel level : GetLevels())
+            {
+                // The dot product has Scalar and SSE2 forms only
+                if (level == SIMDLevel::AVX2)
+                    continue;
+
+                PCMConvert::SetActiveLevel(level);
+                double best = 1e30;
+                for (int run = 0; run < BenchRuns; ++run)
+                {
+                    resampler.Reset();
+                    Clock::time_point start = Clock::now();
+                    for (size_t offset = 0; offset + chunk <= inputCount; offset += chunk)
+                    {
+                        resampler.Process(input.data() + offset, chunk, output.data());
+                    }
+                    best = std::min(best, GetSeconds(start));
+                }
+                std::cout << "  " << PCMConvert::GetLevelName(level) << " " << std::fixed << std::setprecision(0)
+                    << inputCount / best / 1e6;
+            }
+            std::cout << std::endl;
+        }
+        PCMConvert::SetActiveLevel(PCMConvert::GetSupportedLevel());
+    }
+
+    struct ToneResponse
+    {
+        double gainDb;     // Output level at the tone's own frequency (when below the output Nyquist)
+        double residualDb; // Everything else in the output (aliases, images, noise) re the input tone
+    };
+
+    // One second of a 0.5 amplitude tone through a fresh resampler; a least-squares sine
+    // fit at the tone frequency splits the settled output into the tone and the residual
+    ToneResponse MeasureTone(int inputRate, int outputRate, ResampleQuality quality, double frequency)
+    {
+        const double pi = 3.14159265358979;
+        const double amplitude = 0.5;
+
+        std::vector<float> input(inputRate);
+        for (size_t i = 0; i < input.size(); ++i)
+        {
+            input[i] = static_cast<float>(amplitude * std::sin(2.0 * pi * frequency * i / inputRate));
+        }
+
+        Resampler resampler;
+        resampler.Initialize(inputRate, outputRate, quality);
+        std::vector<float> output(resampler.GetMaxOutput(input.size()));
+        output.resize(resampler.Process(input.data(), input.size(), output.data()));
+
+        // Skip the filter's warm-up at the start
+        const size_t first = static_cast<size_t>(resampler.GetTapsPerPhase()) * 4;
+        double cc = 0.0, ss = 0.0, cs = 0.0, yc = 0.0, ys = 0.0, yy = 0.0;
+        const bool fitTone = frequency < 0.5 * outputRate;
+        for (size_t i = first; i < output.size(); ++i)
+        {
+            const double c = fitTone ? std::cos(2.0 * pi * frequency * i / outputRate) : 0.0;
+            const double s = fitTone ? std::sin(2.0 * pi * frequency * i / outputRate) : 0.0;
+            const double y = output[i];
+            cc += c * c; ss += s * s; cs += c * s;
+            yc += y * c; ys += y * s; yy += y * y;
+        }
+
+        const size_t count = output.size() - first;
+        const double inputPower = amplitude * amplitude / 2.0;
+        double tonePower = 0.0;
+        if (fitTone)
+        {
+            const double det = cc * ss - cs * cs;
+            const double a = (yc * ss - ys * cs) / det;
+            const double b = (ys * cc - yc * cs) / det;
+            tonePower = (a * yc + b * ys) / count;
+        }
+        const double residualPower = std::max(yy / count - tonePower, 1e-30);
+
+        ToneResponse response;
+        response.gainDb = 10.0 * std::log10(std::max(tonePower, 1e-30) / inputPower);
+        response.residualDb = 10.0 * std::log10(residualPower / inputPower);
+        return response;
+    }
+
+    // Passband ripple over tones up to 80% of the lower Nyquist; the worst residual over
+    // those tones and, when decimating, over tones that can only alias (past 1.1x the
+    // output Nyquist)
+    void BenchResamplerQuality()
+    {
+        const int conversions[][2] = { { 44100, 48000 }, { 96000, 48000 } };
+        const char* conversionNames[] = { "44.1 -> 48", "96 -> 48" };
+        const ResampleQuality qualities[] = { ResampleQuality::Fast, ResampleQuality::Balanced, ResampleQuality::High };
+        const char* names[] = { "Fast", "Balanced", "High" };
+        const int tones = 32;
+
+        std::cout << "Resampler quality, tone sweep (passband ripple dB, worst alias/image dB)" << std::endl;
+        for (int q = 0; q < 3; ++q)
+        {
+            // Collected first, as every Initialize() logs its filter
+            std::ostringstream line;
+            line << "  " << std::left << std::setw(9) << names[q] << std::right << std::fixed;
+            for (int c = 0; c < 2; ++c)
+            {
+                const int inputRate = conversions[c][0];
+                const int outputRate = conversions[c][1];
+                const double passbandEdge = 0.8 * 0.5 * std::min(inputRate, outputRate);
+
+                double minGain = 1e30, maxGain = -1e30, worstResidual = -1e30;
+                for (int t = 0; t < tones; ++t)
+                {
+                    const double frequency = 20.0 + (passbandEdge - 20.0) * t / (tones - 1);
+                    ToneResponse response = MeasureTone(inputRate, outputRate, qualities[q], frequency);
+                    minGain = std::min(minGain, response.gainDb);
+                    maxGain = std::max(maxGain, response.gainDb);
+                    worstResidual = std::max(worstResidual, response.residualDb);
+                }
+
+                if (inputRate > outputRate)
+                {
+                    const double stopbandEdge = 1.1 * 0.5 * outputRate;
+                    const double inputEdge = 0.98 * 0.5 * inputRate;
+                    for (int t = 0; t < tones; ++t)
+                    {
+                        const double frequency = stopbandEdge + (inputEdge - stopbandEdge) * t / (tones - 1);
+                        worstResidual = std::max(worstResidual, MeasureTone(inputRate, outputRate, qualities[q], frequency).residualDb);
+                    }
+                }
+
+                line << "  " << conversionNames[c] << " kHz " << std::setprecision(3) << std::setw(6) << maxGain - minGain
+                    << " " << std::setprecision(0) << std::setw(5) << worstResidual;
+            }
+            std::cout << line.str() << std::endl;
+        }
+    }
+
+    // 4096-point frames of 800 samples (zero padded), per backend and output set
+    void BenchFFT()
+    {
+        const int fftSize = 4096;
+        const int frameCount = 20000;
+        std::vector<float> input(800);
+        FillNoise(2u, input.data(), input.size());
+
+        std::cout << "FFTProcessor, 4096 points, 800-sample frames (frames/s, heap allocations per frame)" << std::endl;
+        for (FFTBackend backend : { FFTBackend::BuiltIn, FFTBackend::FFTW })
+        {
+            if (!FFTProcessor::IsBackendAvailable(backend))
+                continue;
+
+            FFTProcessor fft(fftSize, backend);
+            WaitUntilMeasured(fft);
+            std::vector<float> magnitudes(fft.GetBinCount()), phases(fft.GetBinCount());
+            FFTResult result;
+
+            struct Case
+            {
+                const char* name;
+                int path;
+            };
+            const Case cases[] = {
+                { "ProcessFFT(vector)", 0 },
+                { "ProcessFFT, reused result", 1 },
+                { "Process, magnitudes + phases", 2 },
+                { "Process, magnitudes only", 3 },
+            };
+
+            std::cout << "  " << FFTProcessor::GetBackendName(fft.GetBackend()) << std::endl;
+            for (const Case& benchCase : cases)
+            {
+                double best = 1e30;
+                uint64_t allocations = 0;
+                for (int run = 0; run < BenchRuns; ++run)
+                {
+                    const uint64_t allocationsBefore = s_allocations.load();
+                    Clock::time_point start = Clock::now();
+                    for (int frame = 0; frame < frameCount; ++frame)
+                    {
+                        float maxMagnitude = 0.0f;
+                        switch (benchCase.path)
+                        {
+                        case 0: result = fft.ProcessFFT(input); break;
+                        case 1: fft.ProcessFFT(Span<const float>(input.data(), input.size()), result); break;
+                        case 2: fft.Process(Span<const float>(input.data(), input.size()), Span<float>(magnitudes.data(), magnitudes.size()),
+                            Span<float>(phases.data(), phases.size()), maxMagnitude); break;
+                        default: fft.Process(Span<const float>(input.data(), input.size()), Span<float>(magnitudes.data(), magnitudes.size()),
+                            Span<float>(), maxMagnitude); break;
+                        }
+                    }
+                    best = std::min(best, GetSeconds(start));
+                    allocations = s_allocations.load() - allocationsBefore;
+                }
+                std::cout << "    " << std::left << std::setw(30) << benchCase.name << std::right << std::fixed << std::setprecision(0)
+                    << std::setw(8) << frameCount / best << std::setprecision(1) << std::setw(6)
+                    << static_cast<double>(allocations) / frameCount << std::endl;
+            }
+        }
+    }
+
+    // A 10-minute 48 kHz track at 4096/1024, per frame through one FFTProcessor and as one
+    // batched Spectrogram call on pools of 1, 2, 4, ... workers (the caller joins in too)
+    void BenchSpectrogram()
+    {
+        const int fftSize = 4096;
+        const int hopSize = 1024;
+        const size_t sampleCount = 48000 * 600;
+        const uint64_t frameCount = (sampleCount - fftSize) / hopSize + 1;
+
+        std::vector<float> track(sampleCount);
+        FillNoise(3u, track.data(), sampleCount);
+
+        std::cout << "Spectrogram, 10 min 48 kHz, 4096/1024 (frames/s)" << std::endl;
+        for (FFTBackend backend : { FFTBackend::BuiltIn, FFTBackend::FFTW })
+        {
+            if (!FFTProcessor::IsBackendAvailable(backend))
+                continue;
+
+            FFTProcessor fft(fftSize, backend);
+            WaitUntilMeasured(fft);
+            std::vector<float> magnitudes(fft.GetBinCount());
+
+            std::cout << "  " << FFTProcessor::GetBackendName(fft.GetBackend()) << std::endl;
+
+            double best = 1e30;
+            for (int run = 0; run < BenchRuns; ++run)
+            {
+                Clock::time_point start = Clock::now();
+                for (uint64_t frame = 0; frame < frameCount; ++frame)
+                {
+                    float maxMagnitude = 0.0f;
+                    fft.Process(Span<const float>(track.data() + frame * hopSize, fftSize),
+                        Span<float>(magnitudes.data(), magnitudes.size()), Span<float>(), maxMagnitude);
+                }
+                best = std::min(best, GetSeconds(start));
+            }
+            std::cout << "    " << std::left << std::setw(30) << "FFTProcessor, per frame" << std::right << std::fixed
+                << std::setprecision(0) << std::setw(8) << frameCount / best << std::endl;
+
+            const size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+            for (size_t workers = 1; ; workers *= 2)
+            {
+                workers = std::min(workers, hardwareThreads);
+                ThreadPool pool(workers);
+                Spectrogram spectrogram;
+
+                best = 1e30;
+                for (int run = 0; run < BenchRuns; ++run)
+                {
+                    Clock::time_point start = Clock::now();
+                    spectrogram.Compute(Span<const float>(track.data(), track.size()), frameCount, fft, hopSize, pool);
+                    best = std::min(best, GetSeconds(start));
+                }
+
+                const std::string name = "Spectrogram, " + std::to_string(workers) + (workers == 1 ? " worker" : " workers");
+                std::cout << "    " << std::left << std::setw(30) << name << std::right << std::fixed
+                    << std::setprecision(0) << std::setw(8) << frameCount / best << std::endl;
+
+                if (workers == hardwareThreads)
+                    break;
+            }
+        }
+    }
+
+    // The live low-latency path against the block STFT on the same stream: a 2048-point
+    // window at 48 kHz, both fed hop-sized blocks so they publish a spectrum equally often.
+    // CPU is the time spent in Push per block; latency runs from the onset of a tone burst
+    // on a tracked bin until the newest spectrum shows half its steady magnitude, counting
+    // the wait for the block and the Push itself.
+    void BenchSlidingDFT()
+    {
+        const int sampleRate = 48000;
+        const int windowSize = 2048;
+        const size_t sampleCount = sampleRate * 60;
+        const int hops[] = { 256, 512, 1024 };
+
+        FrequencyAnalyzer analyzer;
+        const std::vector<int> bins = analyzer.GetBandBins(windowSize, sampleRate);
+        const int toneBin = bins[bins.size() / 4];
+
+        // Quiet noise with a 250 ms burst every 500 ms, the onsets off the hop grid
+        std::vector<float> signal(sampleCount);
+        FillNoise(4u, signal.data(), sampleCount);
+        std::vector<size_t> onsets;
+        for (size_t onset = sampleRate / 4 + 37; onset + sampleRate / 4 < sampleCount; onset += sampleRate / 2 + 101)
+        {
+            onsets.push_back(onset);
+        }
+        for (size_t i = 0; i < sampleCount; ++i)
+        {
+            signal[i] *= 0.04f;
+        }
+        for (size_t onset : onsets)
+        {
+            for (size_t i = 0; i < static_cast<size_t>(sampleRate / 4); ++i)
+            {
+                signal[onset + i] += 0.5f * static_cast<float>(std::sin(2.0 * 3.14159265358979 * toneBin * (onset + i) / windowSize));
+            }
+        }
+
+        // Mean onset latency in ms from the tone bin's magnitude after each block
+        auto getLatency = [&](const std::vector<float>& magnitude, int hop, double pushSeconds)
+        {
+            const float threshold = 0.5f * *std::max_element(magnitude.begin(), magnitude.end());
+            double total = 0.0;
+            for (size_t onset : onsets)
+            {
+                size_t block = onset / hop;
+                while (block < magnitude.size() && magnitude[block] < threshold)
+                    ++block;
+                total += static_cast<double>((block + 1) * hop - onset) / sampleRate;
+            }
+            return (total / onsets.size() + pushSeconds) * 1000.0;
+        };
+
+        std::cout << "Sliding DFT (" << bins.size() << " band bins) vs block STFT, 2048 points at 48 kHz"
+            << " (us per block, % of real time, onset latency ms)" << std::endl;
+        for (int hop : hops)
+        {
+            const size_t blockCount = sampleCount / hop;
+            std::vector<float> stftMagnitude(blockCount), slidingMagnitude(blockCount);
+
+            STFTProcessor stft(windowSize, hop);
+            WaitUntilMeasured(stft.GetFFT());
+            SlidingDFT sliding(windowSize);
+            sliding.Configure(windowSize, bins);
+
+            double stftBest = 1e30, slidingBest = 1e30;
+            for (int run = 0; run < BenchRuns; ++run)
+            {
+                stft.Reset(sampleRate);
+                sliding.Reset(sampleRate);
+                double stftSeconds = 0.0, slidingSeconds = 0.0;
+                float stftLatest = 0.0f;
+
+                for (size_t block = 0; block < blockCount; ++block)
+                {
+                    const float* samples = signal.data() + block * hop;
+
+                    Clock::time_point start = Clock::now();
+                    stft.Push(samples, hop);
+                    stftSeconds += GetSeconds(start);
+                    if (const SpectralFrame* frame = stft.GetFrameByIndex(stft.GetFramesProduced() - 1))
+                        stftLatest = frame->result.magnitudes[toneBin];
+                    stftMagnitude[block] = stftLatest;
+
+                    start = Clock::now();
+                    sliding.Push(samples, hop);
+                    slidingSeconds += GetSeconds(start);
+                    const SpectralFrame* latest = sliding.AcquireLatest();
+                    slidingMagnitude[block] = latest ? latest->result.magnitudes[toneBin] : 0.0f;
+                }
+                stftBest = std::min(stftBest, stftSeconds);
+                slidingBest = std::min(slidingBest, slidingSeconds);
+            }
+
+            const double blockSeconds = static_cast<double>(hop) / sampleRate;
+            std::cout << "  hop " << std::setw(4) << hop << std::fixed << std::setprecision(1)
+                << "  STFT " << std::setw(7) << stftBest / blockCount * 1e6 << " us " << std::setw(5)
+                << stftBest / blockCount / blockSeconds * 100.0 << "% " << std::setw(5)
+                << getLatency(stftMagnitude, hop, stftBest / blockCount) << " ms"
+                << "  sliding " << std::setw(7) << slidingBest / blockCount * 1e6 << " us " << std::setw(5)
+                << slidingBest / blockCount / blockSeconds * 100.0 << "% " << std::setw(5)
+                << getLatency(slidingMagnitude, hop, slidingBest / blockCount) << " ms" << std::endl;
+        }
+    }
+
+    // Click tracks at 48 kHz through the live STFT (4096/1024) in 800-sample blocks
+    void BenchBeatTracker()
+    {
+        const int sampleRate = 48000;
+        const double seconds = 30.0;
+        const size_t blockSize = 800;
+        const float tempos[] = { 70.0f, 90.0f, 100.0f, 120.0f, 128.0f, 140.0f, 160.0f, 174.0f };
+
+        // Keeps the STFT's plan alive (and measured) across the tempos
+        FFTProcessor plan(4096);
+        WaitUntilMeasured(plan);
+
+        std::cout << "Beat tracker, 30 s click tracks + noise 0.02 (BPM error, lock time, us per frame)" << std::endl;
+        for (float bpm : tempos)
+        {
+            const size_t sampleCount = static_cast<size_t>(seconds * sampleRate);
+            std::vector<float> signal(sampleCount);
+            FillNoise(static_cast<uint32_t>(bpm), signal.data(), sampleCount);
+            for (float& sample : signal)
+                sample *= 0.04f;
+
+            // 10 ms decaying 2 kHz click on every beat
+            const double period = 60.0 / bpm;
+            for (double beat = 0.25; beat < seconds; beat += period)
+            {
+                const size_t start = static_cast<size_t>(beat * sampleRate);
+                for (size_t i = 0; i < static_cast<size_t>(sampleRate / 100) && start + i < sampleCount; ++i)
+                {
+                    const double t = static_cast<double>(i) / sampleRate;
+                    signal[start + i] += static_cast<float>(0.8 * std::exp(-t * 400.0) * std::sin(2.0 * 3.14159265358979 * 2000.0 * t));
+                }
+            }
+
+            STFTProcessor stft(4096, 1024);
+            stft.Reset(sampleRate);
+            BeatTracker tracker;
+            tracker.Reset(static_cast<double>(sampleRate) / stft.GetHopSize());
+
+            double trackSeconds = 0.0;
+            uint64_t frames = 0;
+            double lockTime = -1.0;
+            for (size_t offset = 0; offset + blockSize <= sampleCount; offset += blockSize)
+            {
+                const size_t produced = stft.Push(signal.data() + offset, blockSize);
+                const uint64_t end = frames + produced;
+                for (; frames < end; ++frames)
+                {
+                    const SpectralFrame* frame = stft.GetFrameByIndex(frames);
+                    if (!frame)
+                        continue;
+
+                    Clock::time_point start = Clock::now();
+                    tracker.Process(frame->result.magnitudes, frame->time);
+                    trackSeconds += GetSeconds(start);
+
+                    // Locked from the last time the tempo came within 1 BPM and stayed there
+                    const bool locked = std::fabs(tracker.GetBPM() - bpm) < 1.0f;
+                    if (!locked)
+                        lockTime = -1.0;
+                    else if (lockTime < 0.0)
+                        lockTime = frame->time;
+                }
+            }
+
+            std::cout << "  " << std::setw(3) << std::fixed << std::setprecision(0) << bpm << " BPM  " << std::showpos << std::setprecision(2)
+                << tracker.GetBPM() - bpm << std::noshowpos << "  lock " << std::setprecision(1) << lockTime << " s  "
+                << std::setprecision(1) << trackSeconds / std::max<uint64_t>(frames, 1) * 1e6 << " us" << std::endl;
+        }
+    }
+}
+
+void* operator new(size_t size)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+// AlignedAllocator's path (FFTResult and the FFT buffers)
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    const size_t align = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+    void* memory = _aligned_malloc(size ? size : 1, align);
+#else
+    void* memory = std::aligned_alloc(align, (size + align - 1) / align * align + (size ? 0 : align));
+#endif
+    if (memory)
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+#ifdef _MSC_VER
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+int main(int argc, char** argv)
+{
+    const std::string only = argc > 1 ? argv[1] : "";
+    std::cout << "SIMD: " << PCMConvert::GetLevelName(PCMConvert::GetSupportedLevel()) << std::endl;
+
+    if (only.empty() || only == "pcm")
+        BenchPCMConvert();
+    if (only.empty() || only == "resample")
+    {
+        BenchResampler();
+        BenchResamplerQuality();
+    }
+    if (only.empty() || only == "fft")
+        BenchFFT();
+    if (only.empty() || only == "spectrogram")
+        BenchSpectrogram();
+    if (only.empty() || only == "sliding")
+        BenchSlidingDFT();
+    if (only.empty() || only == "beat")
+        BenchBeatTracker();
+    return 0;
+}
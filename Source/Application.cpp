@@ -1,10 +1,19 @@
 #include "Application.h"
 #include "Window/WindowManager.h"
 #include "Graphics/Renderer.h"
-#include "Audio/AudioLoader.h"
 #include "Audio/AudioPlayer.h"
+#include "Audio/StreamingSource.h"
+#include "Audio/TrackLoader.h"
+#include "Audio/LibraryScanner.h"
+#include "Audio/Resampler.h"
+#include "Audio/AnalysisCache.h"
 #include "Audio/FFTProcessor.h"
+#include "Audio/STFTProcessor.h"
+#include "Audio/SlidingDFT.h"
+#include "Audio/MultiResolutionSpectrum.h"
 #include "Audio/FrequencyAnalyzer.h"
+#include "Audio/BeatTracker.h"
+#include "Audio/LoudnessMeter.h"
 #include "Visualization/VisualizationEngine.h"
 #include "Utils/Timer.h"
 #include "GUI/GUIManager.h"
@@ -29,8 +38,32 @@ namespace std {
 //  νϽ  ʱȭ
 Application* Application::s_instance = nullptr;
 
+namespace
+{
+    // B Ű ȯϴ  ̾ƿ (ù ׸ ⺻ ̾ƿ)
+    const std::vector<BandLayout>& GetBandLayoutPresets()
+    {
+        static const std::vector<BandLayout> presets = {
+            { BandSpacing::Default, 0, 0.0f, 0.0f },
+            { BandSpacing::Log, 32, 20.0f, 20000.0f },
+            { BandSpacing::Mel, 40, 20.0f, 16000.0f },
+            { BandSpacing::Bark, 24, 20.0f, 15500.0f },
+            { BandSpacing::Octave, 0, 20.0f, 20000.0f },
+            { BandSpacing::ThirdOctave, 0, 20.0f, 20000.0f }
+        };
+        return presets;
+    }
+
+    // W Ű ȯϴ STFT â Լ (ù ׸ ⺻)
+    const WindowType WindowCycle[] = {
+        WindowType::Hann, WindowType::Hamming, WindowType::BlackmanHarris,
+        WindowType::Kaiser, WindowType::FlatTop, WindowType::Gaussian
+    };
+}
+
 Application::Application()
-    : m_isRunning(false), m_isPlaying(false), m_currentSample(0), m_sampleRate(44100), m_audioDuration(0.0f)
+    : m_contentHash(0), m_isRunning(false), m_isPlaying(false), m_liveAnalysis(LiveAnalysis::BlockSTFT), m_beatClock(0.0), m_playbackRemainder(0.0), m_currentSample(0), m_sampleRate(44100), m_analysisRate(44100),
+      m_audioDuration(0.0f), m_loadProgressLogged(0), m_bandLayoutIndex(0), m_firstFrameReported(false)
 {
     s_instance = this;
 }
@@ -42,6 +75,8 @@ Application::~Application()
 
 bool Application::Initialize(HINSTANCE hInstance, int width, int height)
 {
+    m_launchTime = std::chrono::steady_clock::now();
+
     // ܼ â   ()
     AllocConsole();
     freopen_s((FILE**)stdout, "CONOUT$", "w", stdout);
@@ -70,10 +105,32 @@ bool Application::Initialize(HINSTANCE hInstance, int width, int height)
     std::cout << "Renderer initialized successfully" << std::endl;
 
     // Initialize audio components
-    m_audioLoader = std::make_unique<AudioLoader>();
     m_audioPlayer = std::make_unique<AudioPlayer>();
-    m_fftProcessor = std::make_unique<FFTProcessor>(4096); // 4096 sample window
+    m_audioStream = std::make_unique<StreamingSource>();
+    m_trackLoader = std::make_unique<TrackLoader>();
+    m_libraryScanner = std::make_unique<LibraryScanner>();
+    m_resampler = std::make_unique<Resampler>();
+
+    // м  ĳ (Ʈ  ؽ )
+    std::filesystem::path cacheDirectory = std::filesystem::temp_directory_path() / "MusicVisualizer" / "AnalysisCache";
+    m_analysisCache = std::make_unique<AnalysisCache>(cacheDirectory.u8string());
+    m_trackLoader->SetContentHashing(true);
+
+    //  FFTW wisdom    ٷ ÷  ( ׶忡 )
+    m_wisdomFile = (cacheDirectory.parent_path() / "fftwf.wisdom").u8string();
+    FFTProcessor::ImportWisdom(m_wisdomFile);
+    m_stft = std::make_unique<STFTProcessor>(AnalysisWindowSize, AnalysisHopSize);
+    const FFTProcessor& fft = m_stft->GetFFT();
+    std::cout << FFTProcessor::GetBackendName(fft.GetBackend()) << " FFT plan ready in " << fft.GetPlanTime() * 1000.0 << " ms ("
+        << (fft.GetBackend() == FFTBackend::BuiltIn ? "no planning" : fft.IsPlanMeasured() ? "from wisdom" : "estimated, measuring in background")
+        << ")" << std::endl;
+
+    // ߿ M Ű   ػ FFT ̸  θ   wisdom ٷ 
+    FFTProcessor::PreparePlans({ MultiResolutionFFTSize });
     m_frequencyAnalyzer = std::make_unique<FrequencyAnalyzer>();
+    m_beatTracker = std::make_unique<BeatTracker>();
+    m_loudnessMeter = std::make_unique<LoudnessMeter>();
+    m_slidingDFT = std::make_unique<SlidingDFT>(LowLatencyWindowSize);
     std::cout << "Audio components created" << std::endl;
 
     // Initialize visualization engine
@@ -104,7 +161,8 @@ bool Application::Initialize(HINSTANCE hInstance, int width, int height)
     std::cout << "Timer initialized" << std::endl;
 
     m_isRunning = true;
-    std::cout << "Application initialization completed successfully!" << std::endl;
+    std::chrono::duration<double, std::milli> startupTime = std::chrono::steady_clock::now() - m_launchTime;
+    std::cout << "Application initialization completed successfully! (" << startupTime.count() << " ms)" << std::endl;
     return true;
 }
 
@@ -133,6 +191,13 @@ int Application::Run()
         HandleGUI();
         Update(m_timer->GetDeltaTime());
         Render();
+
+        if (!m_firstFrameReported)
+        {
+            std::chrono::duration<double, std::milli> firstFrameTime = std::chrono::steady_clock::now() - m_launchTime;
+            std::cout << "First frame presented " << firstFrameTime.count() << " ms after launch" << std::endl;
+            m_firstFrameReported = true;
+        }
     }
 
     return static_cast<int>(msg.wParam);
@@ -151,7 +216,7 @@ void Application::HandleGUI()
         std::cout << "File load requested from GUI" << std::endl;
         if (LoadAudioFile())
         {
-            std::cout << "Audio file loaded successfully!" << std::endl;
+            std::cout << "Audio file load started" << std::endl;
         }
         else
         {
@@ -159,9 +224,14 @@ void Application::HandleGUI()
         }
     }
 
+    if (m_guiManager->ShouldLoadNextTrack())
+    {
+        LoadNextInFolder();
+    }
+
     if (m_guiManager->ShouldTogglePlayback())
     {
-        if (!m_audioData.empty())
+        if (HasAudio())
         {
             m_isPlaying = !m_isPlaying;
 
@@ -183,49 +253,335 @@ void Application::HandleGUI()
         }
     }
 
+    //  ̾ƿ ȯ: ̹  ̺ ǹǷ ü Ͼ
+    if (m_guiManager->ShouldCycleBandLayout())
+    {
+        const std::vector<BandLayout>& presets = GetBandLayoutPresets();
+        m_bandLayoutIndex = (m_bandLayoutIndex + 1) % presets.size();
+        const BandLayout& layout = presets[m_bandLayoutIndex];
+        m_frequencyAnalyzer->SetBandLayout(layout);
+
+        //   Ƽ   ̾ƿ ٽ , ĳô ̾ƿ ٽ 
+        ResetAnalysis();
+        OpenAnalysisCache();
+        std::cout << "Band layout: " << layout.GetName() << " (" << layout.GetEdges().size() << " bands)" << std::endl;
+    }
+
+    //  ġ ȯ (簢 <-> ﰢ):   ٲǷ ̾ƿ   ó
+    if (m_guiManager->ShouldToggleBandWeighting())
+    {
+        const BandWeighting weighting = m_frequencyAnalyzer->GetBandWeighting() == BandWeighting::Rectangular
+            ? BandWeighting::Triangular : BandWeighting::Rectangular;
+        m_frequencyAnalyzer->SetBandWeighting(weighting);
+
+        ResetAnalysis();
+        OpenAnalysisCache();
+        std::cout << "Band weighting: " << (weighting == BandWeighting::Triangular ? "triangular" : "rectangular") << std::endl;
+    }
+
+    // â Լ ȯ:  STFT(ǥ,  , ĳ) , ĳô â Լ ٽ 
+    if (m_guiManager->ShouldCycleWindow())
+    {
+        FFTProcessor& fft = m_stft->GetFFT();
+        const WindowType* current = std::find(std::begin(WindowCycle), std::end(WindowCycle), fft.GetWindow().GetType());
+        const size_t count = std::end(WindowCycle) - std::begin(WindowCycle);
+        const WindowType next = WindowCycle[(current - std::begin(WindowCycle) + 1) % count];
+        fft.SetWindow(next);
+
+        // â Լ ٲ STFT ٽ , ĳð  ǽð ΰ ó ä
+        ResetAnalysis();
+        OpenAnalysisCache();
+        std::cout << "STFT window: " << WindowFunction::GetName(next) << std::endl;
+    }
+
+    //  Ű ٽ   STFT 
+    LiveAnalysis requested = m_liveAnalysis;
+    if (m_guiManager->ShouldToggleLowLatency())
+    {
+        requested = m_liveAnalysis == LiveAnalysis::LowLatency ? LiveAnalysis::BlockSTFT : LiveAnalysis::LowLatency;
+    }
+    if (m_guiManager->ShouldToggleMultiResolution())
+    {
+        requested = m_liveAnalysis == LiveAnalysis::MultiResolution ? LiveAnalysis::BlockSTFT : LiveAnalysis::MultiResolution;
+    }
+    if (requested != m_liveAnalysis)
+    {
+        //  ػ Ƽ  FFT ÷ ó    ( ð Ե ʵ)
+        if (requested == LiveAnalysis::MultiResolution && !m_multiResolution)
+        {
+            m_multiResolution = std::make_unique<MultiResolutionSpectrum>(MultiResolutionFFTSize);
+        }
+
+        m_liveAnalysis = requested;
+        ResetAnalysis();
+        switch (m_liveAnalysis)
+        {
+        case LiveAnalysis::LowLatency:
+            std::cout << "Live analysis: sliding DFT (" << m_slidingDFT->GetTrackedBinCount() << " bins)" << std::endl;
+            break;
+        case LiveAnalysis::MultiResolution:
+            std::cout << "Live analysis: multi-resolution (" << m_multiResolution->GetTierCount() << " tiers, "
+                << m_multiResolution->GetWindowSeconds(0) * 1000.0 << "-" << m_multiResolution->GetWindowSeconds(m_multiResolution->GetTierCount() - 1) * 1000.0
+                << " ms windows)" << std::endl;
+            break;
+        default:
+            std::cout << "Live analysis: block STFT (" << m_stft->GetWindowSize() / 2 + 1 << " bins)" << std::endl;
+            break;
+        }
+    }
+
     // GUI  Ʈ
     float currentTime = m_sampleRate > 0 ? (float)m_currentSample / m_sampleRate : 0.0f;
     m_guiManager->SetAudioInfo(m_currentFilename, m_isPlaying, m_audioDuration, currentTime);
-    m_guiManager->SetFFTInfo(4096, (float)m_sampleRate / 2.0f);
+    switch (m_liveAnalysis)
+    {
+    case LiveAnalysis::LowLatency:
+        m_guiManager->SetFFTInfo(m_slidingDFT->GetWindowSize(), (float)m_analysisRate / 2.0f, "Sliding DFT");
+        break;
+    case LiveAnalysis::MultiResolution:
+        m_guiManager->SetFFTInfo(m_multiResolution->GetFFTSize(), (float)m_analysisRate / 2.0f,
+            "Multi-resolution x" + std::to_string(m_multiResolution->GetTierCount()));
+        break;
+    default:
+        m_guiManager->SetFFTInfo(m_stft->GetWindowSize(), (float)m_analysisRate / 2.0f);
+        break;
+    }
 
     m_guiManager->ResetFlags();
 }
 
 void Application::UpdateAudioPlayback(float deltaTime)
 {
-    if (m_isPlaying && !m_audioData.empty())
+    if (m_isPlaying && HasAudio())
     {
-        // Calculate samples per frame for 60 FPS
-        size_t samplesPerFrame = static_cast<size_t>(m_sampleRate / 60.0f);
+        // ̹ ȭ   ðŭ  ( Ʈ ϰ  ӵ )
+        size_t samplesPerFrame = AdvancePlaybackClock(deltaTime);
+
+        const bool useCache = UsesCachedAnalysis();
+        bool finished = m_audioStream->IsFinished();
+        if (!finished && useCache)
+        {
+            // ĳõ м   (FFT , Ʈ  θ )
+            const uint64_t hopFrames = m_cachedAnalysis->GetHopFrames();
+            const uint64_t chunkEnd = m_currentSample + ReadStream(samplesPerFrame);
+            m_currentBands = m_cachedAnalysis->ReadBands(m_currentSample / hopFrames);
+
+            //   ̹   ϴ ĳ Ʈ  
+            m_beatMagnitudes.resize(m_cachedAnalysis->GetBinCount());
+            for (uint64_t frame = (m_currentSample + hopFrames - 1) / hopFrames; frame * hopFrames < chunkEnd; ++frame)
+            {
+                m_cachedAnalysis->ReadMagnitudes(frame, m_beatMagnitudes.data());
+                m_beatTracker->Process(m_beatMagnitudes, static_cast<double>(frame * hopFrames) / m_sampleRate);
+            }
+
+            double playbackTime = static_cast<double>(m_currentSample) / m_sampleRate;
+            BeatInfo beat = m_beatTracker->GetBeatInfo(playbackTime, m_beatClock);
+            m_beatClock = playbackTime;
+            MeterLoudness(static_cast<size_t>(chunkEnd - m_currentSample));
+            m_visualizationEngine->Update(m_currentBands, beat, m_loudnessMeter->GetLevels(), deltaTime);
 
-        if (m_currentSample + samplesPerFrame < m_audioData.size())
+            m_currentSample = static_cast<size_t>(chunkEnd);
+        }
+        else if (!finished)
         {
-            // Extract current audio chunk
-            std::vector<float> audioChunk(m_audioData.begin() + m_currentSample,
-                m_audioData.begin() + m_currentSample + samplesPerFrame);
+            // Ʈ   з  ( )
+            const size_t framesRead = ReadStream(samplesPerFrame);
+
+            // м ÷Ʈ ȯ ( Ʈ ״ )
+            const std::vector<float>* analysisInput = &m_audioChunk;
+            if (m_resampler->IsActive())
+            {
+                m_analysisChunk.resize(m_resampler->GetMaxOutput(samplesPerFrame));
+                m_analysisChunk.resize(m_resampler->Process(m_audioChunk.data(), samplesPerFrame, m_analysisChunk.data()));
+                analysisInput = &m_analysisChunk;
+            }
 
-            // Process FFT
-            auto fftResult = m_fftProcessor->ProcessFFT(audioChunk);
+            // STFT  忡 :   ȩ   
+            size_t framesProduced = m_stft->Push(analysisInput->data(), analysisInput->size());
+            TrackBeats(framesProduced);
+            double playbackTime = static_cast<double>(m_audioStream->GetPosition()) / m_sampleRate;
+            const SpectralFrame* frame = m_stft->GetFrameAt(playbackTime);
 
-            // Analyze frequencies
-            auto frequencyBands = m_frequencyAnalyzer->AnalyzeFrequencies(fftResult, m_sampleRate);
+            if (m_liveAnalysis == LiveAnalysis::LowLatency)
+            {
+                // ø ŵǴ   ٷ  (ȩ  )
+                m_slidingDFT->Push(analysisInput->data(), analysisInput->size());
+                if (const SpectralFrame* latest = m_slidingDFT->AcquireLatest())
+                {
+                    m_currentBands = m_frequencyAnalyzer->AnalyzeFrequencies(latest->result, m_analysisRate);
+                }
+            }
+            else if (m_liveAnalysis == LiveAnalysis::MultiResolution)
+            {
+                // 帶 ڱ Ƽ ֽ Ʈ (  â,  ª â)
+                if (m_multiResolution->Push(analysisInput->data(), analysisInput->size()))
+                {
+                    m_currentBands = m_frequencyAnalyzer->AnalyzeBandMagnitudes(m_multiResolution->GetBandMagnitudes(),
+                        m_multiResolution->GetMaxMagnitude(), m_analysisRate);
+                }
+            }
+            else if (frame)
+            {
+                //   ð STFT Ʈ  (ȩ FFT)
+                m_currentBands = m_frequencyAnalyzer->AnalyzeFrequencies(frame->result, m_analysisRate);
+            }
 
-            // Update visualization
-            m_visualizationEngine->Update(frequencyBands, deltaTime);
+            // Update visualization (ù ȩ    )
+            BeatInfo beat = m_beatTracker->GetBeatInfo(playbackTime, m_beatClock);
+            m_beatClock = playbackTime;
+            MeterLoudness(framesRead);
+            m_visualizationEngine->Update(m_currentBands, beat, m_loudnessMeter->GetLevels(), deltaTime);
 
-            m_currentSample += samplesPerFrame;
+            m_currentSample = m_audioStream->GetPosition();
         }
         else
         {
             // End of audio, stop playing
+            std::cout << "End of stream (underruns: " << m_audioStream->GetUnderrunCount() << ")" << std::endl;
             m_isPlaying = false;
+            m_audioStream->Seek(0);
+            m_resampler->Reset();
             m_currentSample = 0;
+            ResetAnalysis();
+        }
+    }
+}
+
+bool Application::HasAudio() const
+{
+    return m_audioStream && m_audioStream->IsOpen();
+}
+
+bool Application::UsesCachedAnalysis() const
+{
+    // ĳô  STFT ̹Ƿ ٸ ǽð 带 ϸ Ʈ  м
+    return m_cachedAnalysis && m_liveAnalysis == LiveAnalysis::BlockSTFT;
+}
+
+size_t Application::AdvancePlaybackClock(float deltaTime)
+{
+    //   ʴ    Ѱܼ    
+    double frames = static_cast<double>(deltaTime) * m_sampleRate + m_playbackRemainder;
+    size_t wholeFrames = frames > 0.0 ? static_cast<size_t>(frames) : 0;
+    m_playbackRemainder = frames - static_cast<double>(wholeFrames);
+    return wholeFrames;
+}
+
+size_t Application::GetCacheHopFrames() const
+{
+    return static_cast<size_t>(m_sampleRate / CacheRecordsPerSecond);
+}
+
+void Application::ResetAnalysis()
+{
+    m_playbackRemainder = 0.0;
+
+    //  ð Ʈ :  ߰ ٽ ص    ð 
+    const double startTime = static_cast<double>(m_currentSample) / m_sampleRate;
+    m_stft->Reset(m_analysisRate, startTime);
+
+    // ̵ DFT  м Ʈ 尡 д  
+    if (m_liveAnalysis == LiveAnalysis::LowLatency)
+    {
+        m_slidingDFT->Configure(LowLatencyWindowSize, m_frequencyAnalyzer->GetBandBins(LowLatencyWindowSize, m_analysisRate));
+        m_slidingDFT->Reset(m_analysisRate, startTime);
+    }
+
+    //  ػ: 帶   ִ   Ƽ 
+    if (m_liveAnalysis == LiveAnalysis::MultiResolution)
+    {
+        m_multiResolution->Configure(m_analysisRate, m_frequencyAnalyzer->GetBandEdges());
+    }
+
+    //  ̾ƿ ٽ   Ƿ м  带 ٽ Ŵ
+    m_currentBands = m_frequencyAnalyzer->GetBands();
+    ResetBeatTracking();
+
+    //    Ʈ  ä ״
+    m_loudnessMeter->Reset(m_sampleRate, HasAudio() ? m_audioStream->GetChannelCount() : 0);
+}
+
+void Application::ResetBeatTracking()
+{
+    // ǽð STFT ȩ, ĳô ĳ ڵ帶 Ʈ ϳ
+    double frameRate = UsesCachedAnalysis() ? static_cast<double>(m_sampleRate) / m_cachedAnalysis->GetHopFrames()
+        : static_cast<double>(m_analysisRate) / m_stft->GetHopSize();
+    m_beatTracker->Reset(frameRate);
+    m_beatClock = static_cast<double>(m_currentSample) / m_sampleRate;
+}
+
+void Application::TrackBeats(size_t framesProduced)
+{
+    // ̹  STFT     (ť з  ǳʶ)
+    const uint64_t end = m_stft->GetFramesProduced();
+    for (uint64_t index = end - framesProduced; index < end; ++index)
+    {
+        if (const SpectralFrame* frame = m_stft->GetFrameByIndex(index))
+        {
+            m_beatTracker->Process(frame->result.magnitudes, frame->time);
+        }
+    }
+}
+
+void Application::OpenAnalysisCache()
+{
+    // м ĳ Ȯ:  ؼ ٷ ,  ׶忡 
+    AnalysisSettings analysisSettings;
+    analysisSettings.analysisRate = m_analysisRate;
+    analysisSettings.fftSize = m_stft->GetWindowSize();
+    analysisSettings.stftHop = static_cast<uint32_t>(m_stft->GetHopSize());
+    analysisSettings.hopFrames = static_cast<uint32_t>(GetCacheHopFrames());
+    analysisSettings.bandLayout = m_frequencyAnalyzer->GetBandLayout();
+    analysisSettings.bandWeighting = m_frequencyAnalyzer->GetBandWeighting();
+    analysisSettings.window = m_stft->GetFFT().GetWindow().GetType();
+    analysisSettings.windowParameter = m_stft->GetFFT().GetWindow().GetParameter();
+
+    //  ݱ  ĳ ڵ带 Ű 带 м  
+    if (m_cachedAnalysis)
+    {
+        m_currentBands = m_frequencyAnalyzer->GetBands();
+    }
+    m_cachedAnalysis.reset();
+    if (m_contentHash != 0 && HasAudio())
+    {
+        m_cachedAnalysis = m_analysisCache->Open(m_contentHash, m_audioStream->GetView(), analysisSettings);
+        if (!m_cachedAnalysis)
+        {
+            m_analysisCache->BuildAsync(m_audioStream->GetView(), m_contentHash, analysisSettings);
         }
     }
+
+    // ĳ      Ʈ ޶
+    ResetBeatTracking();
+}
+
+size_t Application::ReadStream(size_t frameCount)
+{
+    // м äΰ Բ ٿͽ   äε    ( )
+    const size_t channelCount = static_cast<size_t>(m_audioStream->GetChannelCount());
+    m_audioChunk.resize(frameCount);
+    m_meterInput.resize(channelCount * frameCount);
+    m_meterChannels.resize(channelCount);
+    for (size_t channel = 0; channel < channelCount; ++channel)
+    {
+        m_meterChannels[channel] = m_meterInput.data() + channel * frameCount;
+    }
+
+    return m_audioStream->Read(m_audioChunk.data(), frameCount, m_meterChannels.data());
+}
+
+void Application::MeterLoudness(size_t frameCount)
+{
+    //  Ʈ  ä ״ (ĳ  ߿)
+    if (frameCount > 0)
+    {
+        m_loudnessMeter->Process(m_meterChannels.data(), frameCount);
+    }
 }
 
 void Application::Update(float deltaTime)
 {
+    UpdatePendingLoad();
     UpdateAudioPlayback(deltaTime);
 }
 
@@ -261,7 +617,7 @@ void Application::HandleInput()
             {
                 m_isPlaying = false;
             }
-            else if (!m_audioData.empty())
+            else if (HasAudio())
             {
                 m_isPlaying = true;
             }
@@ -324,44 +680,123 @@ bool Application::LoadAudioFile()
 
         std::cout << "Converted file path: " << filePath << std::endl;
 
-        if (m_audioLoader->LoadWAVFile(filePath, m_audioData, m_sampleRate))
-        {
-            // ðȭ  
-            m_currentSample = 0;
-            m_isPlaying = false;
-            m_audioDuration = (float)m_audioData.size() / m_sampleRate;
+        StartLoad(filePath);
+        return true;
+    }
+    else
+    {
+        std::cout << "File selection cancelled or failed" << std::endl;
+    }
+    return false;
+}
 
-            // ϸ 
-            std::filesystem::path path(filePath);
-            m_currentFilename = path.filename().string();
+void Application::StartLoad(const std::string& filePath)
+{
+    //  ε尡   ̸  ( Ʈ ü   )
+    if (m_pendingLoad)
+    {
+        m_pendingLoad->Cancel();
+    }
 
-            //   ε ε
-            if (m_audioPlayer->LoadWAVFile(filePath))
-            {
-                std::cout << "Audio loaded for both visualization and playback!" << std::endl;
-            }
-            else
-            {
-                std::cout << "Audio loaded for visualization only (playback failed)" << std::endl;
-            }
+    m_pendingLoad = m_trackLoader->Load(filePath);
+    m_loadProgressLogged = 0;
+}
+
+void Application::LoadNextInFolder()
+{
+    if (m_currentPath.empty())
+    {
+        std::cout << "No track loaded; open one with O first" << std::endl;
+        return;
+    }
 
-            std::cout << "Audio file loaded successfully!" << std::endl;
-            std::cout << "Audio data size: " << m_audioData.size() << std::endl;
-            std::cout << "Sample rate: " << m_sampleRate << std::endl;
-            std::cout << "Duration: " << m_audioDuration << " seconds" << std::endl;
+    //    ٽ  ( Ƿ ,  ߰ ϵ ݿ)
+    const std::filesystem::path current = std::filesystem::u8path(m_currentPath);
+    if (!m_libraryScanner->ScanDirectory(current.parent_path().u8string(), m_library, false) || m_library.empty())
+        return;
 
-            return true;
+    //  Ʈ   (̸ ó,   Ͽ  ù )
+    size_t next = 0;
+    for (size_t i = 0; i < m_library.size(); ++i)
+    {
+        if (std::filesystem::u8path(m_library[i].path).filename() == current.filename())
+        {
+            next = (i + 1) % m_library.size();
+            break;
         }
-        else
+    }
+
+    const LibraryEntry& entry = m_library[next];
+    std::cout << "Next track (" << next + 1 << "/" << m_library.size() << "): " << entry.path
+        << " (" << entry.info.duration << " s)" << std::endl;
+    StartLoad(entry.path);
+}
+
+void Application::UpdatePendingLoad()
+{
+    if (!m_pendingLoad)
+        return;
+
+    if (!m_pendingLoad->IsDone())
+    {
+        // 25%   Ȳ 
+        int percent = static_cast<int>(m_pendingLoad->GetProgress() * 100.0f);
+        if (percent >= m_loadProgressLogged + 25)
         {
-            std::cout << "Failed to load audio file!" << std::endl;
+            m_loadProgressLogged = percent - percent % 25;
+            std::cout << "Loading " << m_loadProgressLogged << "% (" << m_pendingLoad->GetBytesParsed() << " bytes, "
+                << m_pendingLoad->GetSamplesConverted() << " samples)" << std::endl;
         }
+        return;
+    }
+
+    std::shared_ptr<TrackLoadJob> job = std::move(m_pendingLoad);
+    m_pendingLoad.reset();
+
+    std::unique_ptr<StreamingSource> stream = job->TakeStream();
+    if (!stream)
+    {
+        std::cout << (job->GetState() == TrackLoadState::Cancelled ? "Audio load cancelled" : "Failed to load audio file!") << std::endl;
+        return;
+    }
+
+    //  Ʈ ü ( Ʈ ⼭ )
+    m_audioStream = std::move(stream);
+
+    // ðȭ  
+    m_currentSample = 0;
+    m_isPlaying = false;
+    m_sampleRate = m_audioStream->GetSampleRate();
+    m_audioDuration = m_audioStream->GetDuration();
+
+    // м Ʈ  (ȯ   ̸  Ʈ м)
+    m_analysisRate = m_resampler->Initialize(m_sampleRate, AnalysisSampleRate) ? AnalysisSampleRate : m_sampleRate;
+
+    ResetAnalysis();
+    m_currentBands = BandView();
+    m_contentHash = job->GetContentHash();
+    OpenAnalysisCache();
+
+    // ϸ 
+    const std::string& filePath = job->GetFilename();
+    std::filesystem::path path(filePath);
+    m_currentFilename = path.filename().string();
+    m_currentPath = filePath;
+
+    //   ε ε
+    if (m_audioPlayer->LoadWAVFile(filePath, m_audioDuration))
+    {
+        std::cout << "Audio loaded for both visualization and playback!" << std::endl;
     }
     else
     {
-        std::cout << "File selection cancelled or failed" << std::endl;
+        std::cout << "Audio loaded for visualization only (playback failed)" << std::endl;
     }
-    return false;
+
+    std::cout << "Audio file loaded successfully!" << std::endl;
+    std::cout << "Audio frames: " << m_audioStream->GetFrameCount() << std::endl;
+    std::cout << "Sample rate: " << m_sampleRate << std::endl;
+    std::cout << "Duration: " << m_audioDuration << " seconds" << std::endl;
 }
 
 void Application::HandleKeyInput(WPARAM key)
@@ -380,6 +815,20 @@ void Application::HandleKeyInput(WPARAM key)
 
 void Application::Shutdown()
 {
+    //   ε带 ϰ   
+    m_pendingLoad.reset();
+    if (m_trackLoader)
+        m_trackLoader.reset();
+    if (m_analysisCache)
+        m_analysisCache->CancelBuilds();
+
+    //   ÷  (FFTW  , μ   )
+    if (m_stft && !m_wisdomFile.empty())
+        FFTProcessor::ExportWisdom(m_wisdomFile);
+    m_currentBands = BandView();
+    m_cachedAnalysis.reset();
+    if (m_audioStream)
+        m_audioStream->Close();
     if (m_visualizationEngine)
         m_visualizationEngine.reset();
     if (m_renderer)
@@ -1,5 +1,7 @@
 #pragma once
 #include <Windows.h>
+#include "Audio/BandView.h"
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <string>
@@ -7,10 +9,21 @@
 //    (include ȯ  )
 class WindowManager;
 class Renderer;
-class AudioLoader;
 class AudioPlayer;
-class FFTProcessor;
+class StreamingSource;
+class TrackLoader;
+class TrackLoadJob;
+class LibraryScanner;
+struct LibraryEntry;
+class Resampler;
+class AnalysisCache;
+class CachedAnalysis;
+class STFTProcessor;
+class SlidingDFT;
+class MultiResolutionSpectrum;
 class FrequencyAnalyzer;
+class BeatTracker;
+class LoudnessMeter;
 class VisualizationEngine;
 class Timer;
 class GUIManager;
@@ -34,25 +47,85 @@ private:
     void HandleInput();
     void HandleGUI();
     bool LoadAudioFile();
+    void StartLoad(const std::string& filePath);
+    void LoadNextInFolder();
+    void UpdatePendingLoad();
     void UpdateAudioPlayback(float deltaTime);
+    bool HasAudio() const;
+    bool UsesCachedAnalysis() const;
+    size_t AdvancePlaybackClock(float deltaTime); // Source frames played since the last update
+    size_t GetCacheHopFrames() const;
+    void ResetAnalysis();
+    void OpenAnalysisCache();
+    void ResetBeatTracking();
+    void TrackBeats(size_t framesProduced);
+    size_t ReadStream(size_t frameCount); // Into m_audioChunk and m_meterChannels
+    void MeterLoudness(size_t frameCount);
 
     std::unique_ptr<WindowManager> m_windowManager;
     std::unique_ptr<Renderer> m_renderer;
-    std::unique_ptr<AudioLoader> m_audioLoader;
     std::unique_ptr<AudioPlayer> m_audioPlayer;
-    std::unique_ptr<FFTProcessor> m_fftProcessor;
+    std::unique_ptr<StreamingSource> m_audioStream;
+    std::unique_ptr<TrackLoader> m_trackLoader;
+    std::shared_ptr<TrackLoadJob> m_pendingLoad; // Background load, swapped in once ready
+    std::unique_ptr<LibraryScanner> m_libraryScanner;
+    std::vector<LibraryEntry> m_library; // WAVs next to the current track, from the last N press
+    std::unique_ptr<Resampler> m_resampler; // Source rate -> AnalysisSampleRate
+    std::unique_ptr<AnalysisCache> m_analysisCache;
+    std::shared_ptr<CachedAnalysis> m_cachedAnalysis; // Set when the current track was found in the cache
+    uint64_t m_contentHash; // Current track's cache key (0 when it could not be hashed)
+    std::unique_ptr<STFTProcessor> m_stft; // Owns the FFT; frames are sampled by playback time
+    std::unique_ptr<SlidingDFT> m_slidingDFT; // Low-latency mode: band bins updated every sample
+    std::unique_ptr<MultiResolutionSpectrum> m_multiResolution; // Multi-resolution mode: window length per band; created when first selected
     std::unique_ptr<FrequencyAnalyzer> m_frequencyAnalyzer;
+    std::unique_ptr<BeatTracker> m_beatTracker; // Fed every STFT frame (or cached record)
+    std::unique_ptr<LoudnessMeter> m_loudnessMeter; // Absolute levels of the source channels
     std::unique_ptr<VisualizationEngine> m_visualizationEngine;
     std::unique_ptr<Timer> m_timer;
     std::unique_ptr<GUIManager> m_guiManager;
 
     bool m_isRunning;
     bool m_isPlaying;
-    std::vector<float> m_audioData;
+    // Live analysis path: m_stft, m_slidingDFT or m_multiResolution
+    enum class LiveAnalysis { BlockSTFT, LowLatency, MultiResolution };
+    LiveAnalysis m_liveAnalysis;
+    std::vector<float> m_audioChunk;
+    std::vector<float> m_analysisChunk;
+    BandView m_currentBands; // Bands shown this frame (cache or live)
+    std::vector<float> m_beatMagnitudes; // Cached spectrum unpacked for the beat tracker
+    double m_beatClock; // Playback time of the last beat query, in seconds
+    std::vector<float> m_meterInput; // Planar source channels read with m_audioChunk, for the loudness meter
+    std::vector<float*> m_meterChannels;
+    double m_playbackRemainder; // Fraction of a source frame carried to the next update
     size_t m_currentSample;
     int m_sampleRate;
+    int m_analysisRate; // Rate the FFT and band tables see
     float m_audioDuration;
     std::string m_currentFilename;
+    std::string m_currentPath; // UTF-8, full path of the playing track
+    int m_loadProgressLogged;
+    std::string m_wisdomFile; // FFTW wisdom, next to the analysis cache
+    size_t m_bandLayoutIndex; // Into the band layout presets, cycled with B
+
+    // Startup instrumentation: Initialize() duration and time to the first presented frame
+    std::chrono::steady_clock::time_point m_launchTime;
+    bool m_firstFrameReported;
+
+    // Analysis cache records per second of audio, independent of the display frame rate
+    static constexpr float CacheRecordsPerSecond = 60.0f;
+
+    // Every track is analysed at this rate so band tables and FFT plans can be shared
+    static constexpr int AnalysisSampleRate = 48000;
+
+    // STFT at the analysis rate: 4096-sample window, 75% overlap (~47 spectra per second)
+    static constexpr int AnalysisWindowSize = 4096;
+    static constexpr int AnalysisHopSize = 1024;
+
+    // Sliding DFT window in low-latency mode (~43 ms at the analysis rate)
+    static constexpr int LowLatencyWindowSize = 2048;
+
+    // Multi-resolution mode: 1024-point FFT per octave tier (~21 ms at the top, longer below)
+    static constexpr int MultiResolutionFFTSize = 1024;
 
     //  νϽ 
     static Application* s_instance;
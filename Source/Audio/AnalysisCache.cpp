@@ -0,0 +1,696 @@
+#include "AnalysisCache.h"
+#include "FFTProcessor.h"
+#include "Resampler.h"
+#include "Spectrogram.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#endif
+
+namespace
+{
+    // Per-frame record: maxMagnitude, bass, mid, treble, then the band and bin data
+    const size_t RecordHeaderFloats = 4;
+
+    // Band arrays per record: amplitudes, smoothed amplitudes, peaks
+    const size_t RecordBandArrays = 3;
+
+    // Magnitudes are stored as 8-bit dB below the frame maximum; 0 means silence
+    const float QuantRangeDB = 96.0f;
+
+    // STFT frames Build transforms at once (~11 s at 48 kHz with a 1024 hop)
+    const uint64_t SpectrogramSegmentFrames = 512;
+
+    size_t GetRecordSize(uint32_t bandCount, uint32_t binCount)
+    {
+        size_t size = (RecordHeaderFloats + bandCount * RecordBandArrays) * sizeof(float) + binCount;
+        return (size + 3) & ~static_cast<size_t>(3);
+    }
+
+    uint8_t QuantizeMagnitude(float magnitude, float maxMagnitude)
+    {
+        if (magnitude <= 0.0f || maxMagnitude <= 0.0f)
+            return 0;
+
+        float db = 20.0f * log10f(magnitude / maxMagnitude) + QuantRangeDB;
+        float level = db * (255.0f / QuantRangeDB) + 0.5f;
+        return static_cast<uint8_t>(std::min(std::max(level, 0.0f), 255.0f));
+    }
+
+    float DequantizeMagnitude(uint8_t level, float maxMagnitude)
+    {
+        if (level == 0)
+            return 0.0f;
+
+        float db = level * (QuantRangeDB / 255.0f) - QuantRangeDB;
+        return maxMagnitude * powf(10.0f, db / 20.0f);
+    }
+
+    BandLayout GetHeaderLayout(const AnalysisCacheHeader& header)
+    {
+        BandLayout layout;
+        layout.spacing = static_cast<BandSpacing>(header.bandSpacing);
+        layout.bandCount = header.layoutBandCount;
+        layout.minFrequency = header.layoutMinFrequency;
+        layout.maxFrequency = header.layoutMaxFrequency;
+        return layout;
+    }
+
+    // Four independent 64-bit lanes in the style of xxHash64, so the whole data chunk
+    // hashes at memory speed
+    const uint64_t HashPrime1 = 0x9E3779B185EBCA87ull;
+    const uint64_t HashPrime2 = 0xC2B2AE3D27D4EB4Full;
+    const uint64_t HashPrime3 = 0x165667B19E3779F9ull;
+
+    inline uint64_t RotateLeft(uint64_t value, int bits)
+    {
+        return (value << bits) | (value >> (64 - bits));
+    }
+
+    inline uint64_t HashRound(uint64_t lane, uint64_t input)
+    {
+        lane += input * HashPrime2;
+        return RotateLeft(lane, 31) * HashPrime1;
+    }
+
+    class ContentHasher
+    {
+    public:
+        explicit ContentHasher(uint64_t seed)
+            : m_length(0)
+        {
+            m_lanes[0] = seed + HashPrime1 + HashPrime2;
+            m_lanes[1] = seed + HashPrime2;
+            m_lanes[2] = seed;
+            m_lanes[3] = seed - HashPrime1;
+        }
+
+        // Every call except the last must pass a multiple of 32 bytes
+        void Update(const uint8_t* data, size_t bytes)
+        {
+            size_t blocks = bytes / 32;
+            for (size_t i = 0; i < blocks; i++)
+            {
+                uint64_t words[4];
+                memcpy(words, data + i * 32, 32);
+                m_lanes[0] = HashRound(m_lanes[0], words[0]);
+                m_lanes[1] = HashRound(m_lanes[1], words[1]);
+                m_lanes[2] = HashRound(m_lanes[2], words[2]);
+                m_lanes[3] = HashRound(m_lanes[3], words[3]);
+            }
+
+            m_tail.assign(data + blocks * 32, data + bytes);
+            m_length += bytes;
+        }
+
+        uint64_t Finish() const
+        {
+            uint64_t hash = RotateLeft(m_lanes[0], 1) + RotateLeft(m_lanes[1], 7) +
+                RotateLeft(m_lanes[2], 12) + RotateLeft(m_lanes[3], 18);
+            hash += m_length;
+
+            size_t i = 0;
+            for (; i + 8 <= m_tail.size(); i += 8)
+            {
+                uint64_t word;
+                memcpy(&word, m_tail.data() + i, 8);
+                hash ^= HashRound(0, word);
+                hash = RotateLeft(hash, 27) * HashPrime1 + HashPrime3;
+            }
+            for (; i < m_tail.size(); i++)
+            {
+                hash ^= m_tail[i] * HashPrime3;
+                hash = RotateLeft(hash, 11) * HashPrime1;
+            }
+
+            hash ^= hash >> 33;
+            hash *= HashPrime2;
+            hash ^= hash >> 29;
+            hash *= HashPrime3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+    private:
+        uint64_t m_lanes[4];
+        uint64_t m_length;
+        std::vector<uint8_t> m_tail;
+    };
+}
+
+CachedAnalysis::CachedAnalysis()
+    : m_header(), m_recordOffset(0), m_recordSize(0)
+{
+}
+
+const uint8_t* CachedAnalysis::GetRecord(uint64_t frame) const
+{
+    frame = std::min(frame, m_header.frameCount - 1);
+    uint64_t offset = m_recordOffset + frame * m_recordSize;
+
+    if (const uint8_t* data = m_file.GetData())
+    {
+        return data + offset;
+    }
+
+    m_staging.resize(m_recordSize);
+    m_file.Read(offset, m_staging.data(), m_recordSize);
+    return m_staging.data();
+}
+
+BandView CachedAnalysis::ReadBands(uint64_t frame) const
+{
+    // Header, band table and record sizes are all multiples of four bytes, so the
+    // arrays are float aligned in the mapping and in the staging buffer alike
+    const float* values = reinterpret_cast<const float*>(GetRecord(frame)) + RecordHeaderFloats;
+    const size_t bandCount = m_bands.size();
+
+    BandView view;
+    view.frequencies = m_frequencies;
+    view.amplitudes = Span<const float>(values, bandCount);
+    view.smoothedAmplitudes = Span<const float>(values + bandCount, bandCount);
+    view.peaks = Span<const float>(values + bandCount * 2, bandCount);
+    return view;
+}
+
+void CachedAnalysis::ReadLevels(uint64_t frame, float& bass, float& mid, float& treble) const
+{
+    const uint8_t* record = GetRecord(frame);
+    memcpy(&bass, record + 1 * sizeof(float), sizeof(float));
+    memcpy(&mid, record + 2 * sizeof(float), sizeof(float));
+    memcpy(&treble, record + 3 * sizeof(float), sizeof(float));
+}
+
+float CachedAnalysis::ReadMagnitudes(uint64_t frame, float* magnitudes) const
+{
+    const uint8_t* record = GetRecord(frame);
+
+    float maxMagnitude;
+    memcpy(&maxMagnitude, record, sizeof(float));
+
+    const uint8_t* levels = record + (RecordHeaderFloats + m_bands.size() * RecordBandArrays) * sizeof(float);
+    for (uint32_t bin = 0; bin < m_header.binCount; bin++)
+    {
+        magnitudes[bin] = DequantizeMagnitude(levels[bin], maxMagnitude);
+    }
+
+    return maxMagnitude;
+}
+
+AnalysisCache::AnalysisCache(const std::string& directory, uint64_t maxBytes)
+    : m_directory(directory), m_maxBytes(maxBytes), m_cancel(false), m_runningKey(0, 0), m_building(false), m_stopping(false)
+{
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::u8path(m_directory), error);
+    if (error)
+    {
+        std::cout << "Failed to create analysis cache directory: " << m_directory << std::endl;
+    }
+}
+
+AnalysisCache::~AnalysisCache()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_buildMutex);
+        m_stopping = true;
+        m_pendingBuild.reset();
+        m_cancel = true;
+    }
+    m_buildChanged.notify_all();
+
+    if (m_buildThread.joinable())
+        m_buildThread.join();
+}
+
+uint64_t AnalysisCache::ComputeContentHash(const PCMView& view, std::atomic<uint64_t>* bytesHashed, const std::atomic<bool>* cancel)
+{
+    if (!view.IsValid())
+        return 0;
+
+    // Two files with identical bytes but different formats or lengths must not collide
+    const WAVFormat& format = view.GetFormat();
+    const uint64_t dataSize = view.GetDataSize();
+    uint64_t seed = (static_cast<uint64_t>(format.sampleRate) << 32) ^
+        (static_cast<uint64_t>(format.numChannels) << 16) ^
+        (static_cast<uint64_t>(format.bitsPerSample) << 8) ^ static_cast<uint64_t>(format.sampleFormat) ^
+        (dataSize * HashPrime3);
+
+    ContentHasher hasher(seed);
+    const size_t blockBytes = 1 << 20; // Multiple of 32
+    std::vector<uint8_t> staging;
+
+    for (uint64_t offset = 0; offset < dataSize; offset += blockBytes)
+    {
+        if (cancel && cancel->load(std::memory_order_relaxed))
+            return 0;
+
+        size_t bytes = static_cast<size_t>(std::min<uint64_t>(blockBytes, dataSize - offset));
+        if (const uint8_t* raw = view.GetRawData())
+        {
+            hasher.Update(raw + offset, bytes);
+        }
+        else
+        {
+            staging.resize(bytes);
+            bytes = view.ReadBytes(offset, staging.data(), bytes);
+            hasher.Update(staging.data(), bytes);
+        }
+
+        if (bytesHashed)
+            bytesHashed->fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    // 0 is reserved for "no hash"
+    uint64_t hash = hasher.Finish();
+    return hash != 0 ? hash : 1;
+}
+
+uint64_t AnalysisCache::GetSettingsKey(const AnalysisSettings& settings)
+{
+    uint32_t fields[12] = {
+        static_cast<uint32_t>(settings.analysisRate),
+        static_cast<uint32_t>(settings.fftSize),
+        settings.stftHop,
+        settings.hopFrames,
+        static_cast<uint32_t>(settings.bandLayout.spacing),
+        static_cast<uint32_t>(settings.bandLayout.bandCount),
+        0, 0,
+        static_cast<uint32_t>(settings.bandWeighting),
+        static_cast<uint32_t>(settings.window),
+        0,
+        FormatVersion
+    };
+    memcpy(&fields[6], &settings.bandLayout.minFrequency, sizeof(float));
+    memcpy(&fields[7], &settings.bandLayout.maxFrequency, sizeof(float));
+    memcpy(&fields[10], &settings.windowParameter, sizeof(float));
+
+    ContentHasher hasher(0);
+    hasher.Update(reinterpret_cast<const uint8_t*>(fields), sizeof(fields));
+    return hasher.Finish();
+}
+
+std::string AnalysisCache::GetEntryPath(uint64_t contentHash, const AnalysisSettings& settings) const
+{
+    char name[48];
+    snprintf(name, sizeof(name), "%016llx-%016llx.mvac", static_cast<unsigned long long>(contentHash),
+        static_cast<unsigned long long>(GetSettingsKey(settings)));
+    return (std::filesystem::u8path(m_directory) / name).u8string();
+}
+
+std::shared_ptr<CachedAnalysis> AnalysisCache::Open(uint64_t contentHash, const PCMView& view, const AnalysisSettings& settings)
+{
+    std::string path = GetEntryPath(contentHash, settings);
+    std::filesystem::path entryPath = std::filesystem::u8path(path);
+
+    std::error_code error;
+    if (!std::filesystem::exists(entryPath, error))
+        return nullptr;
+
+    // Refresh the timestamp first so eviction treats the entry as recently used; the
+    // file cannot be touched once it is mapped
+    std::filesystem::last_write_time(entryPath, std::filesystem::file_time_type::clock::now(), error);
+
+    auto entry = std::make_shared<CachedAnalysis>();
+    bool valid = entry->m_file.Open(path) &&
+        entry->m_file.Read(0, &entry->m_header, sizeof(AnalysisCacheHeader)) == sizeof(AnalysisCacheHeader);
+
+    const AnalysisCacheHeader& header = entry->m_header;
+    valid = valid &&
+        memcmp(header.magic, "MVAC", 4) == 0 &&
+        header.version == FormatVersion &&
+        header.contentHash == contentHash &&
+        header.sourceFrames == view.GetFrameCount() &&
+        header.sourceRate == static_cast<uint32_t>(view.GetSampleRate()) &&
+        header.analysisRate == static_cast<uint32_t>(settings.analysisRate) &&
+        header.fftSize == static_cast<uint32_t>(settings.fftSize) &&
+        header.stftHop == settings.stftHop &&
+        header.hopFrames == settings.hopFrames &&
+        GetHeaderLayout(header) == settings.bandLayout &&
+        header.bandWeighting == static_cast<uint32_t>(settings.bandWeighting) &&
+        header.windowType == static_cast<uint32_t>(settings.window) &&
+        header.windowParameter == settings.windowParameter &&
+        header.frameCount > 0;
+
+    if (valid)
+    {
+        entry->m_recordOffset = sizeof(AnalysisCacheHeader) + header.bandCount * sizeof(AnalysisCacheBand);
+        entry->m_recordSize = GetRecordSize(header.bandCount, header.binCount);
+        valid = entry->m_file.GetSize() == entry->m_recordOffset + header.frameCount * entry->m_recordSize;
+    }
+
+    if (valid)
+    {
+        entry->m_bands.resize(header.bandCount);
+        valid = entry->m_file.Read(sizeof(AnalysisCacheHeader), entry->m_bands.data(),
+            entry->m_bands.size() * sizeof(AnalysisCacheBand)) == entry->m_bands.size() * sizeof(AnalysisCacheBand);
+        for (const AnalysisCacheBand& band : entry->m_bands)
+        {
+            entry->m_frequencies.push_back(band.frequency);
+        }
+    }
+
+    if (!valid)
+    {
+        // Older format, hash collision or a damaged file: drop it so it gets rebuilt
+        entry->m_file.Close();
+        std::filesystem::remove(entryPath, error);
+        std::cout << "Removed stale analysis cache entry: " << path << std::endl;
+        return nullptr;
+    }
+
+    std::cout << "Analysis cache hit: " << header.frameCount << " frames" << std::endl;
+    return entry;
+}
+
+bool AnalysisCache::Build(const PCMView& view, uint64_t contentHash, const AnalysisSettings& settings)
+{
+    if (!view.IsValid() || settings.hopFrames == 0 || contentHash == 0)
+        return false;
+
+    auto buildStart = std::chrono::steady_clock::now();
+
+    const uint64_t sourceFrames = view.GetFrameCount();
+    const uint64_t frameCount = (sourceFrames + settings.hopFrames - 1) / settings.hopFrames;
+    const size_t hop = settings.hopFrames;
+
+    // Same chain as Application::UpdateAudioPlayback (mono chunk -> resampler -> STFT ->
+    // bands), except that the STFT frames are transformed in batches by a Spectrogram,
+    // one segment of the track at a time
+    Resampler resampler;
+    resampler.Initialize(view.GetSampleRate(), settings.analysisRate);
+    FFTProcessor fft(settings.fftSize);
+    fft.SetWindow(settings.window, settings.windowParameter);
+    Spectrogram spectrogram;
+    FrequencyAnalyzer analyzer;
+    analyzer.SetBandLayout(settings.bandLayout);
+    analyzer.SetBandWeighting(settings.bandWeighting);
+
+    const int fftSize = settings.fftSize;
+    const uint64_t stftHop = settings.stftHop;
+    std::vector<float> chunk(hop);
+    std::vector<float> resampled;
+
+    // Analysis-rate samples after the fftSize - stftHop zeros the STFT's history starts
+    // with, so STFT frame k windows samples [k * stftHop, k * stftHop + fftSize). Only the
+    // part from the current segment on is kept: analysis[0] is sample 'analysisStart'.
+    std::vector<float> analysis(static_cast<size_t>(fftSize - stftHop), 0.0f);
+    uint64_t analysisStart = 0;
+    uint64_t samplesPushed = 0; // What the STFT would have been pushed so far
+    std::vector<uint64_t> chunkEnds; // samplesPushed after each source chunk
+    chunkEnds.reserve(static_cast<size_t>(frameCount));
+
+    auto resampleChunk = [&]()
+    {
+        const uint64_t chunkIndex = chunkEnds.size();
+        size_t framesRead = view.ReadFrames(chunkIndex * hop, hop, chunk.data());
+        std::fill(chunk.begin() + framesRead, chunk.end(), 0.0f);
+
+        const std::vector<float>* analysisInput = &chunk;
+        if (resampler.IsActive())
+        {
+            resampled.resize(resampler.GetMaxOutput(hop));
+            resampled.resize(resampler.Process(chunk.data(), hop, resampled.data()));
+            analysisInput = &resampled;
+        }
+
+        analysis.insert(analysis.end(), analysisInput->begin(), analysisInput->end());
+        samplesPushed += analysisInput->size();
+        chunkEnds.push_back(samplesPushed);
+    };
+
+    // Window centre of STFT frame k, as STFTProcessor computes it
+    auto getFrameTime = [&](uint64_t k)
+    {
+        double centre = static_cast<double>((k + 1) * stftHop) - fftSize * 0.5;
+        return centre / settings.analysisRate;
+    };
+
+    // Stands in for the spectrum until the STFT has produced its first frame
+    FFTResult silence;
+    silence.magnitudes.assign(fft.GetBinCount(), 0.0f);
+    silence.sampleCount = fftSize;
+    silence.maxMagnitude = 0.0f;
+    FFTResult spectrum;
+    spectrum.sampleCount = fftSize;
+    spectrum.maxMagnitude = 0.0f;
+    uint64_t stftFrame = 0; // What STFTProcessor::GetFrameAt would return
+    uint64_t segmentFirst = 0;
+    uint64_t segmentFrames = 0;
+
+    std::vector<AnalysisCacheBand> bandTable;
+    std::vector<uint8_t> record; // One frame at a time; the file stream does the batching
+    uint32_t binCount = 0;
+    uint64_t entryBytes = 0;
+
+    // Written under a temporary name and renamed, so a reader never sees a partial entry
+    std::string path = GetEntryPath(contentHash, settings);
+    std::filesystem::path tempPath = std::filesystem::u8path(path + ".tmp");
+    std::ofstream file;
+    auto discard = [&]()
+    {
+        std::error_code error;
+        file.close();
+        std::filesystem::remove(tempPath, error);
+        return false;
+    };
+
+    for (uint64_t frame = 0; frame < frameCount; frame++)
+    {
+        if ((frame & 63) == 0 && m_cancel.load(std::memory_order_relaxed))
+            return discard();
+
+        while (chunkEnds.size() <= frame)
+        {
+            resampleChunk();
+        }
+
+        // Newest frame produced by now whose centre is at or before the end of this chunk
+        const uint64_t produced = chunkEnds[static_cast<size_t>(frame)] / stftHop;
+        const double time = static_cast<double>((frame + 1) * hop) / view.GetSampleRate();
+        while (stftFrame + 1 < produced && getFrameTime(stftFrame + 1) <= time)
+        {
+            stftFrame++;
+        }
+
+        if (produced > 0 && stftFrame >= segmentFirst + segmentFrames)
+        {
+            // Next segment from this frame on: resample ahead far enough for a full one
+            // (or to the end of the track), then drop the samples before it
+            while (chunkEnds.size() < frameCount && samplesPushed < (stftFrame + SpectrogramSegmentFrames) * stftHop)
+            {
+                resampleChunk();
+            }
+
+            segmentFirst = stftFrame;
+            segmentFrames = std::min<uint64_t>(SpectrogramSegmentFrames, samplesPushed / stftHop - segmentFirst);
+            const uint64_t segmentStart = segmentFirst * stftHop;
+            analysis.erase(analysis.begin(), analysis.begin() + static_cast<size_t>(segmentStart - analysisStart));
+            analysisStart = segmentStart;
+
+            if (!spectrogram.Compute(Span<const float>(analysis), segmentFrames, fft, static_cast<int>(stftHop), &m_cancel))
+                return discard();
+        }
+
+        if (produced > 0)
+        {
+            Span<const float> row = spectrogram.GetFrame(stftFrame - segmentFirst);
+            spectrum.magnitudes.assign(row.begin(), row.end());
+            spectrum.maxMagnitude = spectrogram.GetMaxMagnitude(stftFrame - segmentFirst);
+        }
+        const FFTResult& result = produced > 0 ? spectrum : silence;
+        BandView bands = analyzer.AnalyzeFrequencies(result, settings.analysisRate);
+
+        if (frame == 0)
+        {
+            // The first frame fixes the band and bin counts, which is all the header needs
+            binCount = static_cast<uint32_t>(result.magnitudes.size());
+            const BandWeightMatrix& weights = analyzer.GetBandWeights();
+            for (size_t i = 0; i < bands.size(); i++)
+            {
+                int binStart = weights.GetFirstBin(i);
+                bandTable.push_back({ bands.frequencies[i], binStart, binStart + weights.GetBinCount(i) - 1 });
+            }
+            record.resize(GetRecordSize(static_cast<uint32_t>(bandTable.size()), binCount));
+            entryBytes = sizeof(AnalysisCacheHeader) + bandTable.size() * sizeof(AnalysisCacheBand) + frameCount * record.size();
+
+            if (entryBytes > m_maxBytes)
+            {
+                std::cout << "Track too long for the analysis cache (" << entryBytes / (1 << 20) << " MB entry)" << std::endl;
+                return false;
+            }
+
+            AnalysisCacheHeader header = {};
+            memcpy(header.magic, "MVAC", 4);
+            header.version = FormatVersion;
+            header.contentHash = contentHash;
+            header.sourceFrames = sourceFrames;
+            header.sourceRate = static_cast<uint32_t>(view.GetSampleRate());
+            header.analysisRate = static_cast<uint32_t>(settings.analysisRate);
+            header.fftSize = static_cast<uint32_t>(settings.fftSize);
+            header.stftHop = settings.stftHop;
+            header.hopFrames = settings.hopFrames;
+            header.binCount = binCount;
+            header.bandCount = static_cast<uint32_t>(bandTable.size());
+            header.frameCount = frameCount;
+            header.bandSpacing = static_cast<uint32_t>(settings.bandLayout.spacing);
+            header.layoutBandCount = settings.bandLayout.bandCount;
+            header.layoutMinFrequency = settings.bandLayout.minFrequency;
+            header.layoutMaxFrequency = settings.bandLayout.maxFrequency;
+            header.bandWeighting = static_cast<uint32_t>(settings.bandWeighting);
+            header.windowType = static_cast<uint32_t>(settings.window);
+            header.windowParameter = settings.windowParameter;
+
+            file.open(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(bandTable.data()), bandTable.size() * sizeof(AnalysisCacheBand));
+        }
+
+        float* values = reinterpret_cast<float*>(record.data());
+        values[0] = result.maxMagnitude;
+        values[1] = analyzer.GetBassLevel();
+        values[2] = analyzer.GetMidLevel();
+        values[3] = analyzer.GetTrebleLevel();
+        const size_t bandCount = bandTable.size();
+        std::copy(bands.amplitudes.begin(), bands.amplitudes.end(), values + RecordHeaderFloats);
+        std::copy(bands.smoothedAmplitudes.begin(), bands.smoothedAmplitudes.end(), values + RecordHeaderFloats + bandCount);
+        std::copy(bands.peaks.begin(), bands.peaks.end(), values + RecordHeaderFloats + bandCount * 2);
+
+        uint8_t* levels = record.data() + (RecordHeaderFloats + bandCount * RecordBandArrays) * sizeof(float);
+        for (uint32_t bin = 0; bin < binCount; bin++)
+        {
+            levels[bin] = QuantizeMagnitude(result.magnitudes[bin], result.maxMagnitude);
+        }
+
+        file.write(reinterpret_cast<const char*>(record.data()), record.size());
+        if (!file)
+        {
+            std::cout << "Failed to write analysis cache entry: " << path << std::endl;
+            return discard();
+        }
+    }
+
+    file.close();
+    if (frameCount == 0 || !file)
+        return discard();
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, std::filesystem::u8path(path), error);
+    if (error)
+        return discard();
+
+    std::chrono::duration<double> buildTime = std::chrono::steady_clock::now() - buildStart;
+    std::cout << "Analysis cache entry written: " << frameCount << " frames, " << entryBytes / 1024 << " KB in "
+        << buildTime.count() * 1000.0 << " ms" << std::endl;
+
+    Evict();
+    return true;
+}
+
+void AnalysisCache::BuildAsync(const PCMView& view, uint64_t contentHash, const AnalysisSettings& settings)
+{
+    const std::pair<uint64_t, uint64_t> key(contentHash, GetSettingsKey(settings));
+    {
+        std::lock_guard<std::mutex> lock(m_buildMutex);
+        if (m_stopping || (m_building && m_runningKey == key && !m_cancel))
+            return;
+
+        // Settings changed (another layout, window or track): the old build is no longer wanted
+        m_pendingBuild.reset(new BuildRequest{ view, contentHash, settings });
+        if (m_building)
+            m_cancel = true;
+
+        if (!m_buildThread.joinable())
+            m_buildThread = std::thread(&AnalysisCache::BuildLoop, this);
+    }
+    m_buildChanged.notify_all();
+}
+
+void AnalysisCache::BuildLoop()
+{
+#ifdef _WIN32
+    // Builds take seconds; playback, decoding and the UI come first
+    SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+#endif
+
+    std::unique_lock<std::mutex> lock(m_buildMutex);
+    for (;;)
+    {
+        m_buildChanged.wait(lock, [this] { return m_stopping || m_pendingBuild; });
+        if (m_stopping)
+            break;
+
+        std::unique_ptr<BuildRequest> request = std::move(m_pendingBuild);
+        m_runningKey = std::make_pair(request->contentHash, GetSettingsKey(request->settings));
+        m_building = true;
+        m_cancel = false;
+        lock.unlock();
+
+        Build(request->view, request->contentHash, request->settings);
+        request.reset();
+
+        lock.lock();
+        m_building = false;
+        m_buildChanged.notify_all();
+    }
+}
+
+void AnalysisCache::CancelBuilds()
+{
+    std::unique_lock<std::mutex> lock(m_buildMutex);
+    m_pendingBuild.reset();
+    m_cancel = true;
+    m_buildChanged.wait(lock, [this] { return !m_building; });
+    m_cancel = false;
+}
+
+void AnalysisCache::Evict()
+{
+    struct Entry
+    {
+        std::filesystem::path path;
+        std::filesystem::file_time_type lastUsed;
+        uint64_t size;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t totalBytes = 0;
+
+    std::error_code error;
+    for (std::filesystem::directory_iterator it(std::filesystem::u8path(m_directory), error), end; it != end; it.increment(error))
+    {
+        if (it->path().extension() != ".mvac" || !it->is_regular_file(error))
+            continue;
+
+        Entry entry = { it->path(), it->last_write_time(error), it->file_size(error) };
+        totalBytes += entry.size;
+        entries.push_back(entry);
+    }
+
+    if (totalBytes <= m_maxBytes)
+        return;
+
+    std::sort(entries.begin(), entries.end(),
+        [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+
+    // Entries that are mapped right now cannot be deleted on Windows; skip them
+    for (const auto& entry : entries)
+    {
+        if (totalBytes <= m_maxBytes)
+            break;
+
+        if (std::filesystem::remove(entry.path, error))
+        {
+            totalBytes -= entry.size;
+            std::cout << "Evicted analysis cache entry: " << entry.path.filename().u8string() << std::endl;
+        }
+    }
+}
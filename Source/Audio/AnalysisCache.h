@@ -0,0 +1,161 @@
+#pragma once
+#include "AudioLoader.h"
+#include "FrequencyAnalyzer.h"
+#include "WindowFunction.h"
+#include "MappedFile.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// How the cached frames were produced. Each combination gets its own entry per track,
+// so switching layouts back and forth reuses both.
+struct AnalysisSettings
+{
+    int analysisRate = 48000;
+    int fftSize = 4096;     // STFT window
+    uint32_t stftHop = 1024; // Analysis-rate samples between STFT frames
+    uint32_t hopFrames = 0; // Source frames per analysis frame
+    BandLayout bandLayout;
+    BandWeighting bandWeighting = BandWeighting::Rectangular;
+    WindowType window = WindowType::Hann; // STFT window
+    float windowParameter = 0.0f;         // As passed to FFTProcessor::SetWindow
+};
+
+#pragma pack(push, 1)
+struct AnalysisCacheHeader
+{
+    char magic[4];          // "MVAC"
+    uint32_t version;
+    uint64_t contentHash;   // Hash of the PCM data chunk; with the settings key, the file name
+    uint64_t sourceFrames;
+    uint32_t sourceRate;
+    uint32_t analysisRate;
+    uint32_t fftSize;
+    uint32_t stftHop;
+    uint32_t hopFrames;
+    uint32_t binCount;
+    uint32_t bandCount;
+    uint64_t frameCount;    // Analysis frames
+    uint32_t bandSpacing;   // BandLayout the bands were built from
+    int32_t layoutBandCount;
+    float layoutMinFrequency;
+    float layoutMaxFrequency;
+    uint32_t bandWeighting;
+    uint32_t windowType;
+    float windowParameter;
+};
+
+struct AnalysisCacheBand
+{
+    float frequency;
+    int32_t binStart;
+    int32_t binEnd;
+};
+#pragma pack(pop)
+
+// One track's precomputed analysis, read from the mapped cache file. Each frame is a
+// fixed-size record: max magnitude, bass/mid/treble levels, the band arrays (amplitudes,
+// smoothed amplitudes, peaks) and the magnitude spectrum quantised to 8-bit dB.
+// Not thread safe when the file could not be mapped (reads share a staging buffer).
+class CachedAnalysis
+{
+public:
+    CachedAnalysis();
+
+    uint64_t GetFrameCount() const { return m_header.frameCount; }
+    uint32_t GetHopFrames() const { return m_header.hopFrames; }
+    int GetBandCount() const { return static_cast<int>(m_header.bandCount); }
+    int GetBinCount() const { return static_cast<int>(m_header.binCount); }
+
+    // Frame indices past the end read the last frame. The band arrays point straight into
+    // the mapped record; valid until the next read (or while mapped, for as long as this
+    // object lives).
+    BandView ReadBands(uint64_t frame) const;
+    void ReadLevels(uint64_t frame, float& bass, float& mid, float& treble) const;
+
+    // Fills GetBinCount() magnitudes and returns the frame's max magnitude
+    float ReadMagnitudes(uint64_t frame, float* magnitudes) const;
+
+private:
+    friend class AnalysisCache;
+
+    const uint8_t* GetRecord(uint64_t frame) const;
+
+    MappedFile m_file;
+    AnalysisCacheHeader m_header;
+    std::vector<AnalysisCacheBand> m_bands;
+    std::vector<float> m_frequencies; // From m_bands, for BandView
+    uint64_t m_recordOffset;
+    size_t m_recordSize;
+    mutable std::vector<uint8_t> m_staging;
+};
+
+// Directory of per-track analysis files keyed by a content hash of the PCM data (plus
+// the analysis settings), so a renamed or moved file still hits and an edited one misses.
+// The directory is kept under a size limit by dropping the least recently used entries.
+class AnalysisCache
+{
+public:
+    AnalysisCache(const std::string& directory, uint64_t maxBytes = 512ull << 20);
+    ~AnalysisCache(); // Cancels the background build and stops the build thread
+
+    // Hashes the format, the data size and the whole data chunk, so any edit to the
+    // samples changes the key. 'bytesHashed' is advanced as it goes; returns 0 if 'cancel'
+    // was raised.
+    static uint64_t ComputeContentHash(const PCMView& view, std::atomic<uint64_t>* bytesHashed = nullptr,
+        const std::atomic<bool>* cancel = nullptr);
+
+    // Maps the entry for 'contentHash' built with 'settings'. Entries whose header does
+    // not match are stale and get deleted; returns nullptr on a miss.
+    std::shared_ptr<CachedAnalysis> Open(uint64_t contentHash, const PCMView& view, const AnalysisSettings& settings);
+
+    // Analyses the whole track the same way live playback does, streaming the records to
+    // a temporary file that is renamed into place once complete. Tracks whose entry would
+    // not fit in the size limit are skipped.
+    bool Build(const PCMView& view, uint64_t contentHash, const AnalysisSettings& settings);
+
+    // Queues Build() on the cache's own below-normal priority thread, so whole-track
+    // builds never hold up the shared pool. Only the latest request is kept: it replaces
+    // any request still waiting and cancels the running build, unless that build is
+    // already producing this entry.
+    void BuildAsync(const PCMView& view, uint64_t contentHash, const AnalysisSettings& settings);
+    void CancelBuilds(); // Drops the waiting request and waits for the running build to stop
+
+    // Deletes the oldest entries until the directory fits in the size limit
+    void Evict();
+
+    const std::string& GetDirectory() const { return m_directory; }
+
+private:
+    // Entries are named by content hash and a hash of the settings
+    std::string GetEntryPath(uint64_t contentHash, const AnalysisSettings& settings) const;
+    static uint64_t GetSettingsKey(const AnalysisSettings& settings);
+
+    void BuildLoop();
+
+    struct BuildRequest
+    {
+        PCMView view;
+        uint64_t contentHash;
+        AnalysisSettings settings;
+    };
+
+    static constexpr uint32_t FormatVersion = 6;
+
+    std::string m_directory;
+    uint64_t m_maxBytes;
+
+    std::thread m_buildThread; // Started by the first BuildAsync
+    std::atomic<bool> m_cancel; // Stops the running build
+    std::mutex m_buildMutex;
+    std::condition_variable m_buildChanged;
+    std::unique_ptr<BuildRequest> m_pendingBuild;
+    std::pair<uint64_t, uint64_t> m_runningKey; // Content hash and settings key
+    bool m_building;
+    bool m_stopping;
+};
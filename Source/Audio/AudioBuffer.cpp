@@ -0,0 +1,156 @@
+#include "AudioBuffer.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+AudioChannelView::AudioChannelView()
+    : m_channels(nullptr), m_channelCount(0), m_frameCount(0), m_view(ChannelView::Mono)
+{
+}
+
+AudioChannelView::AudioChannelView(const float* const* channels, int channelCount, size_t frameCount, ChannelView view)
+    : m_channels(channels), m_channelCount(channelCount), m_frameCount(frameCount), m_view(view)
+{
+}
+
+const float* AudioChannelView::GetDirect() const
+{
+    if (m_channelCount == 0)
+        return nullptr;
+
+    if (m_channelCount == 1)
+    {
+        // Every view of a mono signal except Side is the signal itself
+        return m_view == ChannelView::Side ? nullptr : m_channels[0];
+    }
+
+    switch (m_view)
+    {
+    case ChannelView::Left: return m_channels[0];
+    case ChannelView::Right: return m_channels[1];
+    default: return nullptr;
+    }
+}
+
+size_t AudioChannelView::Read(size_t start, size_t count, float* output) const
+{
+    if (start >= m_frameCount)
+        return 0;
+
+    count = std::min(count, m_frameCount - start);
+
+    if (const float* direct = GetDirect())
+    {
+        memcpy(output, direct + start, count * sizeof(float));
+        return count;
+    }
+
+    if (m_channelCount == 1) // Side of a mono signal
+    {
+        std::fill(output, output + count, 0.0f);
+        return count;
+    }
+
+    const float* left = m_channels[0] + start;
+    const float* right = m_channels[1] + start;
+
+    if (m_view == ChannelView::Side)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            output[i] = (left[i] - right[i]) * 0.5f;
+        }
+    }
+    else if (m_view == ChannelView::Mid || m_channelCount == 2)
+    {
+        // Mid, or Mono of a stereo signal (same as the interleaved downmix)
+        for (size_t i = 0; i < count; ++i)
+        {
+            output[i] = (left[i] + right[i]) * 0.5f;
+        }
+    }
+    else
+    {
+        // Mono of N channels: average in channel order, like the interleaved downmix
+        std::fill(output, output + count, 0.0f);
+        for (int ch = 0; ch < m_channelCount; ++ch)
+        {
+            const float* channel = m_channels[ch] + start;
+            for (size_t i = 0; i < count; ++i)
+            {
+                output[i] += channel[i];
+            }
+        }
+
+        float channelCount = static_cast<float>(m_channelCount);
+        for (size_t i = 0; i < count; ++i)
+        {
+            output[i] /= channelCount;
+        }
+    }
+
+    return count;
+}
+
+void AudioBuffer::AlignedDeleter::operator()(float* data) const
+{
+    ::operator delete[](data, std::align_val_t(Alignment));
+}
+
+AudioBuffer::AudioBuffer()
+    : m_frameCount(0), m_capacity(0), m_sampleRate(0)
+{
+}
+
+AudioBuffer::~AudioBuffer()
+{
+}
+
+void AudioBuffer::Allocate(int channelCount, size_t frameCount, int sampleRate)
+{
+    m_sampleRate = sampleRate;
+
+    // Reuse the existing arrays when the layout fits
+    if (channelCount == GetChannelCount() && frameCount <= m_capacity)
+    {
+        m_frameCount = frameCount;
+        return;
+    }
+
+    m_channels.clear();
+    m_channelPointers.clear();
+
+    for (int ch = 0; ch < channelCount; ++ch)
+    {
+        float* data = static_cast<float*>(::operator new[](std::max<size_t>(frameCount, 1) * sizeof(float), std::align_val_t(Alignment)));
+        m_channels.emplace_back(data);
+        m_channelPointers.push_back(data);
+    }
+
+    m_frameCount = frameCount;
+    m_capacity = frameCount;
+}
+
+void AudioBuffer::SetFrameCount(size_t frameCount)
+{
+    m_frameCount = std::min(frameCount, m_capacity);
+}
+
+void AudioBuffer::Clear()
+{
+    m_channels.clear();
+    m_channelPointers.clear();
+    m_frameCount = 0;
+    m_capacity = 0;
+    m_sampleRate = 0;
+}
+
+float AudioBuffer::GetDuration() const
+{
+    return m_sampleRate > 0 ? static_cast<float>(m_frameCount) / m_sampleRate : 0.0f;
+}
+
+AudioChannelView AudioBuffer::GetView(ChannelView view) const
+{
+    return AudioChannelView(m_channelPointers.data(), GetChannelCount(), m_frameCount, view);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+enum class ChannelView
+{
+    Mono,   // Average of all channels
+    Left,
+    Right,
+    Mid,    // (L + R) / 2
+    Side    // (L - R) / 2
+};
+
+// Non-owning view that derives one signal from planar channel data on demand.
+// Left/Right (and Mono of a mono buffer) map straight onto stored samples; the
+// combined views are computed only for the frames that are actually read.
+class AudioChannelView
+{
+public:
+    AudioChannelView();
+    AudioChannelView(const float* const* channels, int channelCount, size_t frameCount, ChannelView view);
+
+    size_t GetFrameCount() const { return m_frameCount; }
+    ChannelView GetViewType() const { return m_view; }
+
+    // Pointer to the samples when the view needs no arithmetic, nullptr otherwise
+    const float* GetDirect() const;
+
+    // Writes frames [start, start + count) of the view, returns frames written
+    size_t Read(size_t start, size_t count, float* output) const;
+
+private:
+    const float* const* m_channels;
+    int m_channelCount;
+    size_t m_frameCount;
+    ChannelView m_view;
+};
+
+// Planar (structure-of-arrays) audio: one 64-byte aligned float array per channel
+class AudioBuffer
+{
+public:
+    AudioBuffer();
+    ~AudioBuffer();
+
+    AudioBuffer(AudioBuffer&& other) noexcept = default;
+    AudioBuffer& operator=(AudioBuffer&& other) noexcept = default;
+
+    void Allocate(int channelCount, size_t frameCount, int sampleRate);
+    void SetFrameCount(size_t frameCount); // Shrink only, keeps the allocation
+    void Clear();
+
+    bool IsEmpty() const { return m_frameCount == 0; }
+    int GetChannelCount() const { return static_cast<int>(m_channels.size()); }
+    size_t GetFrameCount() const { return m_frameCount; }
+    int GetSampleRate() const { return m_sampleRate; }
+    float GetDuration() const;
+
+    float* GetChannel(int channel) { return m_channelPointers[channel]; }
+    const float* GetChannel(int channel) const { return m_channelPointers[channel]; }
+    float* const* GetChannels() { return m_channelPointers.data(); }
+    const float* const* GetChannels() const { return m_channelPointers.data(); }
+
+    AudioChannelView GetView(ChannelView view) const;
+
+    static const size_t Alignment = 64;
+
+private:
+    struct AlignedDeleter
+    {
+        void operator()(float* data) const;
+    };
+
+    std::vector<std::unique_ptr<float[], AlignedDeleter>> m_channels;
+    std::vector<float*> m_channelPointers;
+    size_t m_frameCount;
+    size_t m_capacity;
+    int m_sampleRate;
+};
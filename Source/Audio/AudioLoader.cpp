@@ -1,275 +1,369 @@
 #include "AudioLoader.h"
-#include <fstream>
+#include "MappedFile.h"
+#include "../Utils/ThreadPool.h"
 #include <iostream>
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 
-AudioLoader::AudioLoader()
+PCMView::PCMView()
+    : m_dataOffset(0), m_dataSize(0), m_convert(nullptr), m_deinterleave(nullptr)
 {
 }
 
-AudioLoader::~AudioLoader()
+void PCMView::Reset()
 {
+    m_file.reset();
+    m_dataOffset = 0;
+    m_dataSize = 0;
+    m_format = WAVFormat();
+    m_convert = nullptr;
+    m_deinterleave = nullptr;
 }
 
-bool AudioLoader::LoadWAVFile(const std::string& filename, std::vector<float>& audioData, int& sampleRate)
+float PCMView::GetDuration() const
 {
-    std::cout << "Attempting to load file: " << filename << std::endl;
+    return m_format.sampleRate > 0 ? static_cast<float>(GetFrameCount()) / m_format.sampleRate : 0.0f;
+}
 
-    std::ifstream file(filename, std::ios::binary);
-    if (!file.is_open())
-    {
-        std::cout << "Failed to open file: " << filename << std::endl;
-        return false;
-    }
+const uint8_t* PCMView::GetRawData() const
+{
+    if (!m_file || !m_file->IsMapped())
+        return nullptr;
 
-    std::cout << "File opened successfully" << std::endl;
+    return m_file->GetData() + m_dataOffset;
+}
 
-    // Read RIFF header
-    char riffHeader[12];
-    file.read(riffHeader, 12);
+size_t PCMView::ReadBytes(uint64_t offset, void* destination, size_t bytes) const
+{
+    if (!m_file || offset >= m_dataSize)
+        return 0;
+
+    size_t available = static_cast<size_t>(std::min<uint64_t>(bytes, m_dataSize - offset));
+    return m_file->Read(m_dataOffset + offset, destination, available);
+}
 
-    if (file.gcount() != 12)
+size_t PCMView::ReadFrames(uint64_t startFrame, size_t frameCount, float* output) const
+{
+    uint64_t totalFrames = GetFrameCount();
+    if (!IsValid() || startFrame >= totalFrames)
+        return 0;
+
+    size_t framesToRead = static_cast<size_t>(std::min<uint64_t>(frameCount, totalFrames - startFrame));
+
+    // Small reads (streaming, analysis windows) stay on the calling thread
+    if (framesToRead < ParallelThresholdFrames)
     {
-        std::cout << "Failed to read RIFF header" << std::endl;
-        file.close();
-        return false;
+        return ReadFrameRange(startFrame, framesToRead, output);
     }
 
-    if (strncmp(riffHeader, "RIFF", 4) != 0 || strncmp(riffHeader + 8, "WAVE", 4) != 0)
+    // Every frame converts independently, so splitting by frame range gives the same
+    // result as the single-threaded path; each worker writes its own slice of 'output'
+    std::atomic<size_t> framesDone(0);
+    ThreadPool::GetShared().ParallelFor(framesToRead, ParallelGrainFrames,
+        [&](size_t begin, size_t end)
+        {
+            framesDone += ReadFrameRange(startFrame + begin, end - begin, output + begin);
+        });
+
+    return framesDone.load();
+}
+
+size_t PCMView::ReadFrameRange(uint64_t startFrame, size_t framesToRead, float* output) const
+{
+    size_t blockAlign = m_format.blockAlign;
+
+    if (const uint8_t* raw = GetRawData())
     {
-        std::cout << "Not a valid WAV file" << std::endl;
-        file.close();
-        return false;
+        // Mapped: convert straight out of the page cache
+        m_convert(raw + startFrame * blockAlign, framesToRead, output, m_format.numChannels);
+        return framesToRead;
     }
 
-    std::cout << "RIFF/WAVE header OK" << std::endl;
-
-    // ûũ  б
-    uint16_t audioFormat = 0;
-    uint16_t numChannels = 0;
-    uint32_t fileSampleRate = 0;
-    uint16_t bitsPerSample = 0;
-    std::vector<uint8_t> audioDataRaw;
+    // Buffered fallback: stage a bounded block at a time
+    const size_t blockFrames = 16384;
+    std::vector<uint8_t> staging(std::min(framesToRead, blockFrames) * blockAlign);
 
-    while (!file.eof())
+    size_t framesDone = 0;
+    while (framesDone < framesToRead)
     {
-        char chunkId[4];
-        uint32_t chunkSize;
+        size_t frames = std::min(framesToRead - framesDone, blockFrames);
+        uint64_t offset = m_dataOffset + (startFrame + framesDone) * blockAlign;
 
-        file.read(chunkId, 4);
-        if (file.gcount() != 4) break;
+        size_t bytesRead = m_file->Read(offset, staging.data(), frames * blockAlign);
+        frames = bytesRead / blockAlign;
+        if (frames == 0)
+            break;
 
-        file.read(reinterpret_cast<char*>(&chunkSize), 4);
-        if (file.gcount() != 4) break;
+        m_convert(staging.data(), frames, output + framesDone, m_format.numChannels);
+        framesDone += frames;
+    }
 
-        std::cout << "Found chunk: " << std::string(chunkId, 4) << " size: " << chunkSize << std::endl;
+    return framesDone;
+}
 
-        if (strncmp(chunkId, "fmt ", 4) == 0)
-        {
-            // fmt ûũ б
-            if (chunkSize < 16)
-            {
-                std::cout << "fmt chunk too small: " << chunkSize << std::endl;
-                file.close();
-                return false;
-            }
+size_t PCMView::ReadPlanar(uint64_t startFrame, size_t frameCount, float* const* channels, size_t channelOffset) const
+{
+    uint64_t totalFrames = GetFrameCount();
+    if (!IsValid() || startFrame >= totalFrames)
+        return 0;
 
-            file.read(reinterpret_cast<char*>(&audioFormat), 2);
-            file.read(reinterpret_cast<char*>(&numChannels), 2);
-            file.read(reinterpret_cast<char*>(&fileSampleRate), 4);
-            file.seekg(4, std::ios::cur); // byteRate ǳʶٱ
-            file.seekg(2, std::ios::cur); // blockAlign ǳʶٱ
-            file.read(reinterpret_cast<char*>(&bitsPerSample), 2);
+    size_t framesToRead = static_cast<size_t>(std::min<uint64_t>(frameCount, totalFrames - startFrame));
 
-            //  fmt  ǳʶٱ
-            if (chunkSize > 16)
-            {
-                file.seekg(chunkSize - 16, std::ios::cur);
-            }
+    if (framesToRead < ParallelThresholdFrames)
+    {
+        return ReadPlanarRange(startFrame, framesToRead, channels, channelOffset);
+    }
 
-            std::cout << "Format info - Format: " << audioFormat << ", Channels: " << numChannels
-                << ", Sample Rate: " << fileSampleRate << ", Bits: " << bitsPerSample << std::endl;
-        }
-        else if (strncmp(chunkId, "data", 4) == 0)
+    std::atomic<size_t> framesDone(0);
+    ThreadPool::GetShared().ParallelFor(framesToRead, ParallelGrainFrames,
+        [&](size_t begin, size_t end)
         {
-            // data ûũ б
-            std::cout << "Reading audio data: " << chunkSize << " bytes" << std::endl;
-            audioDataRaw.resize(chunkSize);
-            file.read(reinterpret_cast<char*>(audioDataRaw.data()), chunkSize);
+            framesDone += ReadPlanarRange(startFrame + begin, end - begin, channels, channelOffset + begin);
+        });
 
-            if (file.gcount() != chunkSize)
-            {
-                std::cout << "Failed to read audio data. Read " << file.gcount() << " bytes, expected " << chunkSize << std::endl;
-                file.close();
-                return false;
-            }
-            break; // data ûũ ã 
-        }
-        else
-        {
-            // ٸ ûũ ǳʶٱ
-            std::cout << "Skipping chunk: " << std::string(chunkId, 4) << std::endl;
-            file.seekg(chunkSize, std::ios::cur);
-        }
-    }
+    return framesDone.load();
+}
 
-    file.close();
+size_t PCMView::ReadPlanarRange(uint64_t startFrame, size_t framesToRead, float* const* channels, size_t channelOffset) const
+{
+    size_t blockAlign = m_format.blockAlign;
 
-    // ȿ ˻
-    if (audioFormat != 1)
+    if (const uint8_t* raw = GetRawData())
     {
-        std::cout << "Unsupported audio format: " << audioFormat << " (expected PCM = 1)" << std::endl;
-        return false;
+        m_deinterleave(raw + startFrame * blockAlign, framesToRead, channels, channelOffset, m_format.numChannels);
+        return framesToRead;
     }
 
-    if (bitsPerSample != 16 && bitsPerSample != 24 && bitsPerSample != 32)
-    {
-        std::cout << "Unsupported bit depth: " << bitsPerSample << std::endl;
-        return false;
-    }
+    const size_t blockFrames = 16384;
+    std::vector<uint8_t> staging(std::min(framesToRead, blockFrames) * blockAlign);
 
-    if (audioDataRaw.empty())
+    size_t framesDone = 0;
+    while (framesDone < framesToRead)
     {
-        std::cout << "No audio data found" << std::endl;
-        return false;
-    }
+        size_t frames = std::min(framesToRead - framesDone, blockFrames);
+        uint64_t offset = m_dataOffset + (startFrame + framesDone) * blockAlign;
 
-    std::cout << "Audio data read successfully" << std::endl;
+        size_t bytesRead = m_file->Read(offset, staging.data(), frames * blockAlign);
+        frames = bytesRead / blockAlign;
+        if (frames == 0)
+            break;
 
-    // Convert to float format
-    ConvertToFloat(audioDataRaw, audioData, bitsPerSample, numChannels);
-    sampleRate = fileSampleRate;
+        m_deinterleave(staging.data(), frames, channels, channelOffset + framesDone, m_format.numChannels);
+        framesDone += frames;
+    }
 
-    std::cout << "Conversion completed successfully" << std::endl;
-    std::cout << "Final audio data size: " << audioData.size() << " samples" << std::endl;
-    std::cout << "Duration: " << static_cast<float>(audioData.size()) / sampleRate << " seconds" << std::endl;
+    return framesDone;
+}
 
-    return true;
+AudioLoader::AudioLoader()
+{
 }
 
-bool AudioLoader::ValidateWAVHeader(const WAVHeader& header)
+AudioLoader::~AudioLoader()
 {
-    std::cout << "Validating WAV header..." << std::endl;
+}
 
-    // Check RIFF signature
-    if (strncmp(header.chunkID, "RIFF", 4) != 0)
+bool AudioLoader::OpenWAVFile(const std::string& filename, PCMView& view)
+{
+    std::cout << "Attempting to open file: " << filename << std::endl;
+
+    view.Reset();
+
+    auto file = std::make_shared<MappedFile>();
+    if (!file->Open(filename))
     {
-        std::cout << "Invalid RIFF signature: " << std::string(header.chunkID, 4) << std::endl;
+        std::cout << "Failed to open file: " << filename << std::endl;
         return false;
     }
-    std::cout << "RIFF signature OK" << std::endl;
 
-    // Check WAVE format
-    if (strncmp(header.format, "WAVE", 4) != 0)
+    if (!ParseChunks(*file, view, true))
     {
-        std::cout << "Invalid WAVE format: " << std::string(header.format, 4) << std::endl;
+        view.Reset();
         return false;
     }
-    std::cout << "WAVE format OK" << std::endl;
 
-    // Check fmt chunk
-    if (strncmp(header.subchunk1ID, "fmt ", 4) != 0)
+    view.m_file = file;
+
+    std::cout << "Format info - Format: " << view.m_format.audioFormat << ", Channels: " << view.m_format.numChannels
+        << ", Sample Rate: " << view.m_format.sampleRate << ", Bits: " << view.m_format.bitsPerSample << std::endl;
+    std::cout << "Frames: " << view.GetFrameCount() << ", Duration: " << view.GetDuration() << " seconds" << std::endl;
+
+    return true;
+}
+
+bool AudioLoader::ProbeWAVFile(const std::string& filename, WAVInfo& info)
+{
+    info = WAVInfo();
+
+    // Headers sit in the first few hundred bytes; a buffered read is cheaper than
+    // setting up a mapping of the whole file
+    MappedFile file;
+    if (!file.Open(filename, false))
     {
-        std::cout << "Invalid fmt chunk: " << std::string(header.subchunk1ID, 4) << std::endl;
         return false;
     }
-    std::cout << "fmt chunk OK" << std::endl;
 
-    // Check data chunk
-    if (strncmp(header.subchunk2ID, "data", 4) != 0)
+    PCMView view;
+    if (!ParseChunks(file, view, false))
     {
-        std::cout << "Invalid data chunk: " << std::string(header.subchunk2ID, 4) << std::endl;
-        std::cout << "Expected 'data', got: ";
-        for (int i = 0; i < 4; i++) {
-            std::cout << "0x" << std::hex << (int)(unsigned char)header.subchunk2ID[i] << " ";
-        }
-        std::cout << std::dec << std::endl;
         return false;
     }
-    std::cout << "data chunk OK" << std::endl;
 
-    // Check PCM format
-    if (header.audioFormat != 1)
+    info.format = view.m_format;
+    info.frameCount = view.GetFrameCount();
+    info.dataOffset = view.m_dataOffset;
+    info.dataSize = view.m_dataSize;
+    info.duration = view.GetDuration();
+    return true;
+}
+
+bool AudioLoader::ParseChunks(const MappedFile& file, PCMView& view, bool verbose)
+{
+    // Read RIFF header (RF64/BW64 files carry their real sizes in a ds64 chunk)
+    char riffHeader[12];
+    if (file.Read(0, riffHeader, 12) != 12)
     {
-        std::cout << "Unsupported audio format: " << header.audioFormat << " (expected PCM = 1)" << std::endl;
+        if (verbose) std::cout << "Failed to read RIFF header" << std::endl;
         return false;
     }
-    std::cout << "PCM format OK" << std::endl;
 
-    // Check supported bit depths
-    if (header.bitsPerSample != 16 && header.bitsPerSample != 24 && header.bitsPerSample != 32)
+    bool isRF64 = strncmp(riffHeader, "RF64", 4) == 0 || strncmp(riffHeader, "BW64", 4) == 0;
+    if ((strncmp(riffHeader, "RIFF", 4) != 0 && !isRF64) || strncmp(riffHeader + 8, "WAVE", 4) != 0)
     {
-        std::cout << "Unsupported bit depth: " << header.bitsPerSample << " (supported: 16, 24, 32)" << std::endl;
+        if (verbose) std::cout << "Not a valid WAV file" << std::endl;
         return false;
     }
-    std::cout << "Bit depth OK: " << header.bitsPerSample << std::endl;
 
-    std::cout << "WAV header validation passed!" << std::endl;
-    return true;
-}
-
-void AudioLoader::ConvertToFloat(const std::vector<uint8_t>& rawData, std::vector<float>& floatData,
-    int bitsPerSample, int numChannels)
-{
-    size_t numSamples = rawData.size() / (bitsPerSample / 8) / numChannels;
-    floatData.resize(numSamples);
+    if (verbose) std::cout << std::string(riffHeader, 4) << "/WAVE header OK" << std::endl;
 
-    const uint8_t* data = rawData.data();
+    // ûũ  б
+    WAVFormat format;
+    bool foundFormat = false;
+    bool foundData = false;
+    uint64_t ds64DataSize = 0;
+    uint64_t offset = 12;
 
-    for (size_t i = 0; i < numSamples; ++i)
+    while (offset + 8 <= file.GetSize())
     {
-        float sample = 0.0f;
+        char chunkHeader[8];
+        if (file.Read(offset, chunkHeader, 8) != 8) break;
 
-        if (bitsPerSample == 16)
-        {
-            // Convert from 16-bit signed integer
-            int16_t* samples = (int16_t*)data;
+        uint32_t chunkSize;
+        memcpy(&chunkSize, chunkHeader + 4, 4);
+        uint64_t chunkData = offset + 8;
 
-            if (numChannels == 1)
-            {
-                sample = static_cast<float>(samples[i]) / 32768.0f;
-            }
-            else // Stereo - convert to mono by averaging
+        if (verbose) std::cout << "Found chunk: " << std::string(chunkHeader, 4) << " size: " << chunkSize << std::endl;
+
+        if (strncmp(chunkHeader, "ds64", 4) == 0)
+        {
+            // ds64: riffSize(8), dataSize(8), sampleCount(8), table...
+            uint8_t ds64[16];
+            if (chunkSize < 16 || file.Read(chunkData, ds64, 16) != 16)
             {
-                float left = static_cast<float>(samples[i * 2]) / 32768.0f;
-                float right = static_cast<float>(samples[i * 2 + 1]) / 32768.0f;
-                sample = (left + right) * 0.5f;
+                if (verbose) std::cout << "Invalid ds64 chunk" << std::endl;
+                return false;
             }
+            memcpy(&ds64DataSize, ds64 + 8, 8);
         }
-        else if (bitsPerSample == 24)
+        else if (strncmp(chunkHeader, "fmt ", 4) == 0)
         {
-            // Convert from 24-bit signed integer
-            for (size_t ch = 0; ch < numChannels; ++ch)
+            // fmt ûũ б
+            if (chunkSize < 16)
             {
-                size_t index = (i * numChannels + ch) * 3;
-                int32_t value = (data[index + 2] << 16) | (data[index + 1] << 8) | data[index];
+                if (verbose) std::cout << "fmt chunk too small: " << chunkSize << std::endl;
+                return false;
+            }
 
-                // Sign extend
-                if (value & 0x800000)
-                    value |= 0xFF000000;
+            uint8_t fmt[40];
+            size_t fmtSize = std::min<size_t>(chunkSize, sizeof(fmt));
+            if (file.Read(chunkData, fmt, fmtSize) != fmtSize) break;
 
-                sample += static_cast<float>(value) / 8388608.0f;
+            memcpy(&format.audioFormat, fmt, 2);
+            memcpy(&format.numChannels, fmt + 2, 2);
+            memcpy(&format.sampleRate, fmt + 4, 4);
+            memcpy(&format.blockAlign, fmt + 12, 2);
+            memcpy(&format.bitsPerSample, fmt + 14, 2);
+            format.validBitsPerSample = format.bitsPerSample;
+
+            if (format.audioFormat == WaveFormatExtensible)
+            {
+                // cbSize(2), validBits(2), channelMask(4), SubFormat GUID(16)
+                static const uint8_t guidTail[14] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71 };
+                if (fmtSize < 40 || memcmp(fmt + 26, guidTail, sizeof(guidTail)) != 0)
+                {
+                    if (verbose) std::cout << "Unsupported WAVE_FORMAT_EXTENSIBLE sub-format" << std::endl;
+                    return false;
+                }
+
+                memcpy(&format.validBitsPerSample, fmt + 18, 2);
+                memcpy(&format.channelMask, fmt + 20, 4);
+                memcpy(&format.audioFormat, fmt + 24, 2); // Sub-format tag: 1 = PCM, 3 = float
+                format.isExtensible = true;
             }
-            sample /= numChannels; // Average channels
+
+            foundFormat = true;
         }
-        else if (bitsPerSample == 32)
+        else if (strncmp(chunkHeader, "data", 4) == 0)
         {
-            // Convert from 32-bit signed integer
-            int32_t* samples = (int32_t*)data;
-
-            if (numChannels == 1)
+            // data ûũ  ʰ ġ 
+            uint64_t dataSize = chunkSize;
+            if (isRF64 && chunkSize == 0xFFFFFFFF)
             {
-                sample = static_cast<float>(samples[i]) / 2147483648.0f;
+                dataSize = ds64DataSize;
             }
-            else // Stereo - convert to mono by averaging
+
+            view.m_dataOffset = chunkData;
+            view.m_dataSize = std::min<uint64_t>(dataSize, file.GetSize() - chunkData);
+
+            if (view.m_dataSize != dataSize)
             {
-                float left = static_cast<float>(samples[i * 2]) / 2147483648.0f;
-                float right = static_cast<float>(samples[i * 2 + 1]) / 2147483648.0f;
-                sample = (left + right) * 0.5f;
+                if (verbose) std::cout << "Data chunk truncated: " << view.m_dataSize << " of " << dataSize << " bytes present" << std::endl;
             }
+
+            foundData = true;
+            break; // data ûũ ã 
         }
+        else
+        {
+            // ٸ ûũ ǳʶٱ
+            if (verbose) std::cout << "Skipping chunk: " << std::string(chunkHeader, 4) << std::endl;
+        }
+
+        // RIFF chunks are word aligned
+        offset = chunkData + chunkSize + (chunkSize & 1);
+    }
 
-        // Clamp to [-1.0, 1.0]
-        floatData[i] = std::clamp(sample, -1.0f, 1.0f);
+    // ȿ ˻
+    if (!foundFormat)
+    {
+        if (verbose) std::cout << "No fmt chunk found" << std::endl;
+        return false;
     }
-}
\ No newline at end of file
+
+    if (!PCMConvert::GetSampleFormat(format.audioFormat, format.bitsPerSample, format.sampleFormat))
+    {
+        if (verbose) std::cout << "Unsupported audio format: " << format.audioFormat << " with " << format.bitsPerSample
+            << " bits (supported: PCM 8/16/24/32, float 32/64)" << std::endl;
+        return false;
+    }
+
+    if (format.numChannels == 0 || format.blockAlign != format.numChannels * PCMConvert::GetBytesPerSample(format.sampleFormat))
+    {
+        if (verbose) std::cout << "Invalid block alignment: " << format.blockAlign << std::endl;
+        return false;
+    }
+
+    if (!foundData || view.m_dataSize < format.blockAlign)
+    {
+        if (verbose) std::cout << "No audio data found" << std::endl;
+        return false;
+    }
+
+    view.m_format = format;
+    view.m_convert = PCMConvert::SelectKernel(format.sampleFormat, format.numChannels);
+    view.m_deinterleave = PCMConvert::SelectDeinterleaveKernel(format.sampleFormat, format.numChannels);
+
+    if (verbose) std::cout << "Conversion kernel: " << PCMConvert::GetLevelName(PCMConvert::GetActiveLevel()) << std::endl;
+    return true;
+}
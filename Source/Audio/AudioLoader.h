@@ -1,25 +1,89 @@
 #pragma once
+#include "PCMConvert.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <cstdint>
 
-#pragma pack(push, 1)
-struct WAVHeader
+class MappedFile;
+
+// WAVE_FORMAT_EXTENSIBLE; the real format tag is in the SubFormat GUID
+const uint16_t WaveFormatExtensible = 0xFFFE;
+
+struct WAVFormat
+{
+    uint16_t audioFormat = 0;        // 1 = PCM, 3 = IEEE float (resolved from SubFormat for extensible)
+    uint16_t numChannels = 0;
+    uint32_t sampleRate = 0;
+    uint16_t blockAlign = 0;
+    uint16_t bitsPerSample = 0;      // Container size
+    uint16_t validBitsPerSample = 0;
+    uint32_t channelMask = 0;        // Speaker positions, extensible files only
+    bool isExtensible = false;
+    SampleFormat sampleFormat = SampleFormat::Int16;
+};
+
+// Header-only summary of a WAV file, filled without reading any samples
+struct WAVInfo
 {
-    char chunkID[4];        // "RIFF"
-    uint32_t chunkSize;     // File size - 8
-    char format[4];         // "WAVE"
-    char subchunk1ID[4];    // "fmt "
-    uint32_t subchunk1Size; // 16 for PCM
-    uint16_t audioFormat;   // 1 for PCM
-    uint16_t numChannels;   // Mono = 1, Stereo = 2
-    uint32_t sampleRate;    // 44100, 48000, etc.
-    uint32_t byteRate;      // sampleRate * numChannels * bitsPerSample / 8
-    uint16_t blockAlign;    // numChannels * bitsPerSample / 8
-    uint16_t bitsPerSample; // 16, 24, 32
-    char subchunk2ID[4];    // "data"
-    uint32_t subchunk2Size; // Number of bytes in data
+    WAVFormat format;
+    uint64_t frameCount = 0;
+    uint64_t dataOffset = 0; // Byte offset of the first sample
+    uint64_t dataSize = 0;
+    float duration = 0.0f;
+};
+
+// Read-only view over the PCM samples of an opened WAV file. The samples stay in the
+// (mapped) file and are only converted to float when a frame range is requested, so
+// memory use follows the window being read rather than the file size.
+class PCMView
+{
+public:
+    PCMView();
+
+    bool IsValid() const { return m_file != nullptr && m_format.blockAlign > 0; }
+    void Reset();
+
+    const WAVFormat& GetFormat() const { return m_format; }
+    int GetSampleRate() const { return static_cast<int>(m_format.sampleRate); }
+    int GetChannelCount() const { return m_format.numChannels; }
+    uint64_t GetFrameCount() const { return m_format.blockAlign ? m_dataSize / m_format.blockAlign : 0; }
+    float GetDuration() const;
+
+    uint64_t GetDataOffset() const { return m_dataOffset; }
+    uint64_t GetDataSize() const { return m_dataSize; }
+
+    // Pointer to the raw interleaved samples, nullptr when the file could not be mapped
+    const uint8_t* GetRawData() const;
+
+    // Copies raw sample bytes starting 'offset' bytes into the data chunk; works mapped or not
+    size_t ReadBytes(uint64_t offset, void* destination, size_t bytes) const;
+
+    // Converts frames [startFrame, startFrame + frameCount) to mono float.
+    // Returns the number of frames written (less than requested at the end of the data).
+    // Large ranges are split across the shared thread pool.
+    size_t ReadFrames(uint64_t startFrame, size_t frameCount, float* output) const;
+
+    // Splits frames [startFrame, startFrame + frameCount) into planar channels, writing
+    // channel ch from channels[ch][channelOffset]. Returns the number of frames written.
+    size_t ReadPlanar(uint64_t startFrame, size_t frameCount, float* const* channels, size_t channelOffset = 0) const;
+
+private:
+    friend class AudioLoader;
+
+    size_t ReadFrameRange(uint64_t startFrame, size_t frameCount, float* output) const;
+    size_t ReadPlanarRange(uint64_t startFrame, size_t frameCount, float* const* channels, size_t channelOffset) const;
+
+    static constexpr size_t ParallelThresholdFrames = 1 << 20;
+    static constexpr size_t ParallelGrainFrames = 1 << 18;
+
+    std::shared_ptr<MappedFile> m_file;
+    uint64_t m_dataOffset;
+    uint64_t m_dataSize;
+    WAVFormat m_format;
+    PCMConvertFunc m_convert; // Chosen once per file in AudioLoader::ParseChunks
+    PCMDeinterleaveFunc m_deinterleave;
 };
-#pragma pack(pop)
 
 class AudioLoader
 {
@@ -27,10 +91,13 @@ public:
     AudioLoader();
     ~AudioLoader();
 
-    bool LoadWAVFile(const std::string& filename, std::vector<float>& audioData, int& sampleRate);
+    // Maps the file and parses its RIFF chunks in place without touching the samples
+    bool OpenWAVFile(const std::string& filename, PCMView& view);
+
+    // Parses the RIFF chunks only, for playlists and library scans. Logs nothing, so it
+    // can run on many files at once.
+    bool ProbeWAVFile(const std::string& filename, WAVInfo& info);
 
 private:
-    bool ValidateWAVHeader(const WAVHeader& header);
-    void ConvertToFloat(const std::vector<uint8_t>& rawData, std::vector<float>& floatData,
-        int bitsPerSample, int numChannels);
-};
\ No newline at end of file
+    bool ParseChunks(const MappedFile& file, PCMView& view, bool verbose);
+};
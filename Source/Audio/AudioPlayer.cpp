@@ -14,7 +14,7 @@ AudioPlayer::~AudioPlayer()
     Stop();
 }
 
-bool AudioPlayer::LoadWAVFile(const std::string& filename)
+bool AudioPlayer::LoadWAVFile(const std::string& filename, float knownDuration)
 {
     Stop(); //   
 
@@ -27,7 +27,7 @@ bool AudioPlayer::LoadWAVFile(const std::string& filename)
 
     m_currentFile = filename;
 
-    // MCI ؼ   Ȯ
+    // MCI   
     std::wstring command = L"open \"" + wideFilename + L"\" type waveaudio alias myWAV";
     MCIERROR result = mciSendString(command.c_str(), nullptr, 0, nullptr);
 
@@ -39,14 +39,21 @@ bool AudioPlayer::LoadWAVFile(const std::string& filename)
         return false;
     }
 
-    //   
-    wchar_t lengthStr[256];
-    result = mciSendString(L"status myWAV length", lengthStr, 256, nullptr);
-    if (result == 0)
+    //    ( ̹ ˰  MCI ٽ  )
+    if (knownDuration > 0.0f)
+    {
+        m_duration = knownDuration;
+    }
+    else
     {
-        m_duration = (float)_wtoi(lengthStr) / 1000.0f; // ms ʷ ȯ
-        std::wcout << L"Audio duration: " << m_duration << L" seconds" << std::endl;
+        wchar_t lengthStr[256];
+        result = mciSendString(L"status myWAV length", lengthStr, 256, nullptr);
+        if (result == 0)
+        {
+            m_duration = (float)_wtoi(lengthStr) / 1000.0f; // ms ʷ ȯ
+        }
     }
+    std::wcout << L"Audio duration: " << m_duration << L" seconds" << std::endl;
 
     std::cout << "Audio file loaded successfully for playback" << std::endl;
     return true;
@@ -9,7 +9,8 @@ public:
     AudioPlayer();
     ~AudioPlayer();
 
-    bool LoadWAVFile(const std::string& filename);
+    // Pass the duration from the loader's header parse to skip the MCI length query
+    bool LoadWAVFile(const std::string& filename, float knownDuration = 0.0f);
     bool Play();
     void Pause();
     void Stop();
@@ -0,0 +1,193 @@
+#include "BandLayout.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace
+{
+    // Layout with the fields its spacing ignores cleared, so equal layouts compare and
+    // key equal
+    BandLayout Normalize(const BandLayout& layout)
+    {
+        BandLayout normalized = layout;
+        if (layout.spacing == BandSpacing::Default)
+        {
+            normalized.bandCount = 0;
+            normalized.minFrequency = 0.0f;
+            normalized.maxFrequency = 0.0f;
+        }
+        else if (layout.spacing == BandSpacing::Octave || layout.spacing == BandSpacing::ThirdOctave)
+        {
+            normalized.bandCount = 0;
+        }
+        return normalized;
+    }
+
+    std::vector<BandEdges> GetDefaultEdges()
+    {
+        // Define frequency ranges: SubBass, Bass, LowMid, Mid, HighMid, Presence, Brilliance
+        std::vector<BandEdges> edges = {
+            {20.0f, 60.0f},
+            {60.0f, 250.0f},
+            {250.0f, 500.0f},
+            {500.0f, 2000.0f},
+            {2000.0f, 4000.0f},
+            {4000.0f, 6000.0f},
+            {6000.0f, 20000.0f}
+        };
+
+        // Add additional fine-grained bands for more detailed visualization
+        int numDetailBands = 16;
+        float minLogFreq = log10f(80.0f);   // Start from 80 Hz
+        float maxLogFreq = log10f(8000.0f); // Up to 8 kHz
+        float logStep = (maxLogFreq - minLogFreq) / numDetailBands;
+
+        for (int i = 0; i < numDetailBands; ++i)
+        {
+            float logFreq1 = minLogFreq + i * logStep;
+            float logFreq2 = minLogFreq + (i + 1) * logStep;
+            edges.push_back({ powf(10.0f, logFreq1), powf(10.0f, logFreq2) });
+        }
+
+        return edges;
+    }
+
+    double HzToMel(double hz) { return 2595.0 * log10(1.0 + hz / 700.0); }
+    double MelToHz(double mel) { return 700.0 * (pow(10.0, mel / 2595.0) - 1.0); }
+
+    // Traunmueller (1990); the inverse is exact
+    double HzToBark(double hz) { return 26.81 * hz / (1960.0 + hz) - 0.53; }
+    double BarkToHz(double bark) { return 1960.0 * (bark + 0.53) / (26.28 - bark); }
+
+    // 'count' adjacent bands equally spaced on the scale given by 'toScale'
+    template <typename ToScale, typename FromScale>
+    std::vector<BandEdges> SplitEvenly(const BandLayout& layout, ToScale toScale, FromScale fromScale)
+    {
+        std::vector<BandEdges> edges;
+        const double low = toScale(layout.minFrequency);
+        const double step = (toScale(layout.maxFrequency) - low) / layout.bandCount;
+
+        float lower = layout.minFrequency;
+        for (int i = 1; i <= layout.bandCount; ++i)
+        {
+            float upper = i == layout.bandCount ? layout.maxFrequency : static_cast<float>(fromScale(low + step * i));
+            edges.push_back({ lower, upper });
+            lower = upper;
+        }
+        return edges;
+    }
+
+    std::vector<BandEdges> GetFractionalOctaveEdges(const BandLayout& layout, int bandsPerOctave)
+    {
+        // Centres 1000 * 2^(k / b), edges half a band either side (IEC 61260 base-2)
+        std::vector<BandEdges> edges;
+        const double halfBand = pow(2.0, 0.5 / bandsPerOctave);
+        const int first = static_cast<int>(ceil(bandsPerOctave * log2(layout.minFrequency / 1000.0) - 1e-9));
+        const int last = static_cast<int>(floor(bandsPerOctave * log2(layout.maxFrequency / 1000.0) + 1e-9));
+
+        for (int k = first; k <= last; ++k)
+        {
+            double centre = 1000.0 * pow(2.0, static_cast<double>(k) / bandsPerOctave);
+            edges.push_back({ static_cast<float>(centre / halfBand), static_cast<float>(centre * halfBand) });
+        }
+        return edges;
+    }
+
+    std::mutex s_registryMutex;
+    std::map<std::tuple<int, int, float, float, int, int, int>, std::shared_ptr<const BandTable>> s_registry;
+}
+
+std::vector<BandEdges> BandLayout::GetEdges() const
+{
+    if (spacing == BandSpacing::Default)
+        return GetDefaultEdges();
+
+    // Every other spacing needs a positive range (and octaves a positive lower edge)
+    if (!(minFrequency >= 0.0f && maxFrequency > minFrequency))
+        return {};
+
+    switch (spacing)
+    {
+    case BandSpacing::Log:
+        if (bandCount <= 0 || minFrequency <= 0.0f)
+            return {};
+        return SplitEvenly(*this, [](double hz) { return log(hz); }, [](double value) { return exp(value); });
+    case BandSpacing::Mel:
+        if (bandCount <= 0)
+            return {};
+        return SplitEvenly(*this, HzToMel, MelToHz);
+    case BandSpacing::Bark:
+        if (bandCount <= 0)
+            return {};
+        return SplitEvenly(*this, HzToBark, BarkToHz);
+    case BandSpacing::Octave:
+        return minFrequency > 0.0f ? GetFractionalOctaveEdges(*this, 1) : std::vector<BandEdges>();
+    case BandSpacing::ThirdOctave:
+        return minFrequency > 0.0f ? GetFractionalOctaveEdges(*this, 3) : std::vector<BandEdges>();
+    default:
+        return {};
+    }
+}
+
+const char* BandLayout::GetName() const
+{
+    switch (spacing)
+    {
+    case BandSpacing::Default: return "Default";
+    case BandSpacing::Log: return "Log";
+    case BandSpacing::Mel: return "Mel";
+    case BandSpacing::Bark: return "Bark";
+    case BandSpacing::Octave: return "Octave";
+    case BandSpacing::ThirdOctave: return "1/3 octave";
+    default: return "Unknown";
+    }
+}
+
+bool BandLayout::operator==(const BandLayout& other) const
+{
+    BandLayout a = Normalize(*this);
+    BandLayout b = Normalize(other);
+    return a.spacing == b.spacing && a.bandCount == b.bandCount &&
+        a.minFrequency == b.minFrequency && a.maxFrequency == b.maxFrequency;
+}
+
+BandTable::BandTable(const BandLayout& layout, BandWeighting weighting, int fftSize, int sampleRate)
+    : m_layout(Normalize(layout))
+{
+    std::vector<BandEdges> edges = m_layout.GetEdges();
+    m_weights.Build(edges, fftSize, sampleRate, weighting);
+
+    // Center frequencies; bands stay even when they cover no bins so they line up with
+    // the layout's edges. The default layout keeps its arithmetic centres, the others
+    // use the geometric centre, which is exact for octave bands.
+    for (const BandEdges& band : edges)
+    {
+        bool geometric = m_layout.spacing != BandSpacing::Default && band.minFrequency > 0.0f;
+        m_frequencies.push_back(geometric ? sqrtf(band.minFrequency * band.maxFrequency)
+            : (band.minFrequency + band.maxFrequency) * 0.5f);
+    }
+}
+
+bool BandTable::Matches(const BandLayout& layout, BandWeighting weighting, int fftSize, int sampleRate) const
+{
+    return GetFFTSize() == fftSize && GetSampleRate() == sampleRate && GetWeighting() == weighting && m_layout == layout;
+}
+
+std::shared_ptr<const BandTable> BandTable::Get(const BandLayout& layout, BandWeighting weighting, int fftSize, int sampleRate)
+{
+    if (fftSize <= 0 || sampleRate <= 0)
+        return nullptr;
+
+    const BandLayout key = Normalize(layout);
+
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    std::shared_ptr<const BandTable>& table = s_registry[std::make_tuple(static_cast<int>(key.spacing), key.bandCount,
+        key.minFrequency, key.maxFrequency, static_cast<int>(weighting), fftSize, sampleRate)];
+    if (!table)
+    {
+        table = std::make_shared<const BandTable>(key, weighting, fftSize, sampleRate);
+    }
+    return table;
+}
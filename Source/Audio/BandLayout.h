@@ -0,0 +1,65 @@
+#pragma once
+#include "BandWeightMatrix.h"
+#include <memory>
+#include <vector>
+
+enum class BandSpacing
+{
+    Default,    // The seven named ranges plus 16 log bands from 80 Hz to 8 kHz (count and range ignored)
+    Log,        // Equal frequency ratios
+    Mel,        // Equal steps in mel (2595 log10(1 + f / 700))
+    Bark,       // Equal steps in Bark (Traunmueller's formula)
+    Octave,     // Base-2 octaves centred on 1 kHz (count ignored)
+    ThirdOctave // Base-2 third octaves centred on 1 kHz (count ignored)
+};
+
+// Which bands to analyse: spacing, count and frequency range. Log, mel and Bark layouts
+// split [minFrequency, maxFrequency] into 'bandCount' adjacent bands; octave layouts
+// take every standard band whose centre lies in the range.
+struct BandLayout
+{
+    BandSpacing spacing = BandSpacing::Default;
+    int bandCount = 32;
+    float minFrequency = 20.0f;
+    float maxFrequency = 20000.0f;
+
+    // Band edges in band order; empty when the layout is invalid
+    std::vector<BandEdges> GetEdges() const;
+    const char* GetName() const;
+
+    bool operator==(const BandLayout& other) const;
+    bool operator!=(const BandLayout& other) const { return !(*this == other); }
+};
+
+// A layout compiled for one spectrum size and rate: centre frequencies and the bin
+// weights. Tables never change once built; BandTable::Get hands the same table to every
+// analyzer that asks, so switching between sizes, rates or layouts already seen is a
+// lookup instead of a rebuild.
+class BandTable
+{
+public:
+    BandTable(const BandLayout& layout, BandWeighting weighting, int fftSize, int sampleRate);
+
+    BandTable(const BandTable&) = delete;
+    BandTable& operator=(const BandTable&) = delete;
+
+    const BandLayout& GetLayout() const { return m_layout; }
+    BandWeighting GetWeighting() const { return m_weights.GetWeighting(); }
+    int GetFFTSize() const { return m_weights.GetFFTSize(); }
+    int GetSampleRate() const { return m_weights.GetSampleRate(); }
+
+    size_t GetBandCount() const { return m_frequencies.size(); }
+    const std::vector<float>& GetFrequencies() const { return m_frequencies; } // Band centres in Hz
+    const BandWeightMatrix& GetWeights() const { return m_weights; }
+
+    bool Matches(const BandLayout& layout, BandWeighting weighting, int fftSize, int sampleRate) const;
+
+    // Shared table for (layout, weighting, fftSize, sampleRate), built on first use;
+    // thread safe
+    static std::shared_ptr<const BandTable> Get(const BandLayout& layout, BandWeighting weighting, int fftSize, int sampleRate);
+
+private:
+    BandLayout m_layout;
+    std::vector<float> m_frequencies;
+    BandWeightMatrix m_weights;
+};
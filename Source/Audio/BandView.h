@@ -0,0 +1,17 @@
+#pragma once
+#include "../Utils/Span.h"
+
+// One frame of band output as parallel arrays (index = band), read only. The arrays
+// belong to whoever produced the frame: a FrequencyAnalyzer keeps them valid through its
+// next analysis (double buffered) and until its band layout changes, a CachedAnalysis
+// until its next read.
+struct BandView
+{
+    Span<const float> frequencies;        // Centre frequency in Hz; layout, not per frame
+    Span<const float> amplitudes;         // 0.0 - 1.0
+    Span<const float> smoothedAmplitudes; // Smoothed for animation
+    Span<const float> peaks;              // Decaying peak hold of the amplitudes
+
+    size_t size() const { return amplitudes.size(); }
+    bool empty() const { return amplitudes.empty(); }
+};
@@ -0,0 +1,124 @@
+#include "BandWeightMatrix.h"
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+BandWeightMatrix::BandWeightMatrix()
+    : m_fftSize(0), m_sampleRate(0), m_weighting(BandWeighting::Rectangular), m_nonZeroCount(0)
+{
+}
+
+void BandWeightMatrix::Build(const std::vector<BandEdges>& bands, int fftSize, int sampleRate, BandWeighting weighting)
+{
+    m_fftSize = fftSize;
+    m_sampleRate = sampleRate;
+    m_weighting = weighting;
+    m_rowStart.clear();
+    m_firstBin.clear();
+    m_binCount.clear();
+    m_rowScale.clear();
+    m_weights.clear();
+    m_nonZeroCount = 0;
+
+    if (fftSize <= 0 || sampleRate <= 0)
+        return;
+
+    const int lastBin = fftSize / 2;
+    const double binWidth = static_cast<double>(sampleRate) / fftSize;
+    std::vector<float> row;
+
+    for (const BandEdges& band : bands)
+    {
+        int firstBin = 0;
+        row.clear();
+
+        if (weighting == BandWeighting::Rectangular)
+        {
+            // Same truncating bin mapping the analyzer has always used
+            firstBin = std::max(static_cast<int>(band.minFrequency * fftSize / sampleRate), 0);
+            int endBin = std::min(static_cast<int>(band.maxFrequency * fftSize / sampleRate), lastBin);
+            row.assign(std::max(endBin - firstBin + 1, 0), 1.0f);
+        }
+        else if (band.minFrequency > 0.0f && band.maxFrequency > band.minFrequency)
+        {
+            // Triangle on a log axis: 1 at the centre, 0 one band width away from it
+            const double logCentre = 0.5 * (log(band.minFrequency) + log(band.maxFrequency));
+            const double logWidth = log(band.maxFrequency) - log(band.minFrequency);
+            firstBin = std::max(static_cast<int>(ceil(exp(logCentre - logWidth) / binWidth)), 1);
+            int endBin = std::min(static_cast<int>(floor(exp(logCentre + logWidth) / binWidth)), lastBin);
+
+            for (int bin = firstBin; bin <= endBin; ++bin)
+            {
+                double distance = fabs(log(bin * binWidth) - logCentre) / logWidth;
+                row.push_back(static_cast<float>(std::max(0.0, 1.0 - distance)));
+            }
+
+            // Narrower than a bin: the bin nearest the centre stands in for it
+            if (row.empty())
+            {
+                firstBin = std::min(static_cast<int>(exp(logCentre) / binWidth + 0.5), lastBin);
+                row.push_back(1.0f);
+            }
+        }
+
+        float sum = 0.0f;
+        for (float weight : row)
+        {
+            sum += weight;
+        }
+
+        m_rowStart.push_back(static_cast<uint32_t>(m_weights.size()));
+        m_firstBin.push_back(firstBin);
+        m_binCount.push_back(static_cast<int>(row.size()));
+        m_rowScale.push_back(sum > 0.0f ? 1.0f / sum : 0.0f);
+        m_weights.insert(m_weights.end(), row.begin(), row.end());
+        m_weights.resize((m_weights.size() + 3) & ~static_cast<size_t>(3), 0.0f);
+        m_nonZeroCount += row.size();
+    }
+}
+
+bool BandWeightMatrix::Apply(Span<const float> magnitudes, Span<float> bandValues) const
+{
+    const size_t bandCount = GetBandCount();
+    if (bandValues.size() < bandCount)
+        return false;
+
+    if (magnitudes.size() < static_cast<size_t>(GetSpectrumBinCount()))
+    {
+        std::fill(bandValues.begin(), bandValues.begin() + bandCount, 0.0f);
+        return false;
+    }
+
+    for (size_t band = 0; band < bandCount; ++band)
+    {
+        const float* bins = magnitudes.data() + m_firstBin[band];
+        const float* weights = m_weights.data() + m_rowStart[band];
+        const int count = m_binCount[band];
+
+        // Two accumulators for the wide treble rows; most bass rows only reach the tail
+        __m128 sum0 = _mm_setzero_ps();
+        __m128 sum1 = _mm_setzero_ps();
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(bins + i), _mm_load_ps(weights + i)));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(bins + i + 4), _mm_load_ps(weights + i + 4)));
+        }
+        for (; i + 4 <= count; i += 4)
+        {
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(bins + i), _mm_load_ps(weights + i)));
+        }
+
+        float lanes[4];
+        _mm_storeu_ps(lanes, _mm_add_ps(sum0, sum1));
+        float sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        for (; i < count; ++i)
+        {
+            sum += bins[i] * weights[i];
+        }
+
+        bandValues[band] = sum * m_rowScale[band];
+    }
+
+    return true;
+}
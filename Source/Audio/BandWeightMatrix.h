@@ -0,0 +1,59 @@
+#pragma once
+#include "../Utils/AlignedAllocator.h"
+#include "../Utils/Span.h"
+#include <cstdint>
+#include <vector>
+
+struct BandEdges
+{
+    float minFrequency;
+    float maxFrequency;
+};
+
+enum class BandWeighting
+{
+    Rectangular, // Every bin from the bin of minFrequency to the bin of maxFrequency, weight 1
+    Triangular   // Mel-style: peaks at the band's log centre and reaches zero half a band
+                 // beyond each edge, so neighbouring log bands cross at 0.5 and sum to 1
+};
+
+// Band layout compiled against one spectrum size: band b is the weighted mean of its
+// bins. Stored as CSR whose rows are runs of consecutive bins, so the column indices
+// collapse to one first bin per row and Apply() reads the spectrum with plain SSE2
+// loads. Cost is the number of non-zero weights, not bins x bands.
+class BandWeightMatrix
+{
+public:
+    BandWeightMatrix();
+
+    void Build(const std::vector<BandEdges>& bands, int fftSize, int sampleRate, BandWeighting weighting);
+
+    // One value per band into 'bandValues'. Returns false (and zeros) when 'magnitudes'
+    // has fewer than GetSpectrumBinCount() bins or 'bandValues' fewer than GetBandCount().
+    bool Apply(Span<const float> magnitudes, Span<float> bandValues) const;
+
+    size_t GetBandCount() const { return m_firstBin.size(); }
+    int GetFFTSize() const { return m_fftSize; }
+    int GetSampleRate() const { return m_sampleRate; }
+    int GetSpectrumBinCount() const { return m_fftSize / 2 + 1; }
+    BandWeighting GetWeighting() const { return m_weighting; }
+
+    // Bins band 'band' reads: [GetFirstBin, GetFirstBin + GetBinCount)
+    int GetFirstBin(size_t band) const { return m_firstBin[band]; }
+    int GetBinCount(size_t band) const { return m_binCount[band]; }
+    size_t GetNonZeroCount() const { return m_nonZeroCount; }
+
+private:
+    int m_fftSize;
+    int m_sampleRate;
+    BandWeighting m_weighting;
+
+    // Row b's m_binCount[b] weights start at m_weights[m_rowStart[b]], a multiple of
+    // four so they load aligned
+    std::vector<uint32_t> m_rowStart;
+    std::vector<int> m_firstBin;
+    std::vector<int> m_binCount;
+    std::vector<float> m_rowScale; // 1 / sum of the row's weights (0 for empty rows)
+    AlignedVector<float> m_weights;
+    size_t m_nonZeroCount;
+};
@@ -0,0 +1,242 @@
+#include "BeatTracker.h"
+#include <algorithm>
+#include <cmath>
+
+BeatTracker::BeatTracker(float minBPM, float maxBPM)
+    : m_minBPM(std::max(minBPM, 1.0f)), m_maxBPM(std::max(maxBPM, minBPM * 1.5f)), m_frameRate(0.0),
+      m_historySize(0), m_writePos(0), m_frameCount(0), m_lastTime(0.0),
+      m_period(0.0), m_candidatePeriod(0.0), m_beatTime(0.0), m_hasGrid(false), m_confidence(0.0f)
+{
+    Reset(48000.0 / 1024.0);
+}
+
+void BeatTracker::Reset(double frameRate)
+{
+    m_frameRate = frameRate > 0.0 ? frameRate : m_frameRate;
+    m_onsets.Reset(m_frameRate);
+
+    m_historySize = std::max(static_cast<size_t>(HistorySeconds * m_frameRate + 0.5), static_cast<size_t>(4));
+    m_history.assign(m_historySize * 2, 0.0f);
+    m_writePos = 0;
+    m_frameCount = 0;
+    m_lastTime = 0.0;
+
+    m_period = 0.0;
+    m_candidatePeriod = 0.0;
+    m_beatTime = 0.0;
+    m_hasGrid = false;
+    m_confidence = 0.0f;
+}
+
+void BeatTracker::Process(Span<const float> magnitudes, double time)
+{
+    const float novelty = m_onsets.Process(magnitudes, time);
+
+    m_history[m_writePos] = novelty;
+    m_history[m_writePos + m_historySize] = novelty;
+    m_writePos = (m_writePos + 1) % m_historySize;
+    m_frameCount++;
+    m_lastTime = time;
+
+    if (m_frameCount % TempoInterval == 0)
+    {
+        EstimateTempo();
+        if (m_period > 0.0)
+        {
+            EstimatePhase();
+        }
+    }
+}
+
+float BeatTracker::GetNovelty(double framesBack) const
+{
+    // Linear interpolation between frames; 0 is the newest frame
+    const float* newest = m_history.data() + m_writePos + m_historySize - 1;
+    const size_t whole = static_cast<size_t>(framesBack);
+    if (whole + 1 >= m_historySize)
+        return 0.0f;
+
+    const float fraction = static_cast<float>(framesBack - whole);
+    return newest[-static_cast<ptrdiff_t>(whole)] * (1.0f - fraction) + newest[-static_cast<ptrdiff_t>(whole) - 1] * fraction;
+}
+
+void BeatTracker::EstimateTempo()
+{
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(m_frameCount, m_historySize));
+    const int minLag = std::max(static_cast<int>(m_frameRate * 60.0 / m_maxBPM), 1);
+    const int maxLag = static_cast<int>(ceil(m_frameRate * 60.0 / m_minBPM));
+
+    // Need a few periods of the slowest tempo before estimating
+    if (count < static_cast<size_t>(maxLag) * 3)
+        return;
+
+    // Widen every spike to three frames ([1 2 1] / 4) first, so the correlation between
+    // two lags interpolates sensibly
+    const float* raw = m_history.data() + m_writePos + m_historySize - count;
+    m_smoothed.resize(count);
+    float* data = m_smoothed.data();
+    data[0] = raw[0];
+    data[count - 1] = raw[count - 1];
+    for (size_t i = 1; i + 1 < count; ++i)
+    {
+        data[i] = 0.25f * raw[i - 1] + 0.5f * raw[i] + 0.25f * raw[i + 1];
+    }
+
+    float mean = 0.0f;
+    for (size_t i = 0; i < count; ++i)
+    {
+        mean += data[i];
+    }
+    mean /= count;
+
+    // Normalised autocorrelation of the mean-removed novelty, out to the last multiple
+    // of the longest period that gets scored
+    const int lastLag = std::min(maxLag * PeriodMultiples + 1, static_cast<int>(count) - 1);
+    m_autocorrelation.assign(lastLag + 1, 0.0f);
+    for (int lag = 0; lag <= lastLag; ++lag)
+    {
+        if (lag > 0 && lag < minLag - 1)
+            continue;
+
+        float sum = 0.0f;
+        for (size_t i = lag; i < count; ++i)
+        {
+            sum += (data[i] - mean) * (data[i - lag] - mean);
+        }
+        m_autocorrelation[lag] = sum / (count - lag);
+    }
+
+    const float energy = m_autocorrelation[0];
+    if (energy <= 0.0f)
+        return;
+
+    auto correlationAt = [&](double lag)
+    {
+        const int whole = static_cast<int>(lag);
+        const float fraction = static_cast<float>(lag - whole);
+        return (m_autocorrelation[whole] * (1.0f - fraction) + m_autocorrelation[whole + 1] * fraction) / energy;
+    };
+
+    // A period is scored by the mean correlation at its first few multiples, less half
+    // that halfway between them. Twice the true period also lines up at every multiple,
+    // but the true beats fall halfway between, so it loses; the true period's off-beats
+    // are quiet.
+    auto score = [&](double lag)
+    {
+        float sum = 0.0f;
+        int multiples = 0;
+        for (int k = 1; k <= PeriodMultiples && lag * k < lastLag; ++k, ++multiples)
+        {
+            sum += correlationAt(lag * k) - 0.5f * correlationAt(lag * (k - 0.5));
+        }
+
+        double octaves = log2(m_frameRate * 60.0 / lag / PreferredBPM) / PriorWidth;
+        return sum / std::max(multiples, 1) * static_cast<float>(exp(-0.5 * octaves * octaves));
+    };
+
+    // Periods between frames matter: a click train a fraction of a frame off every lag
+    // splits its correlation over two lags and would lose to half its tempo
+    double bestLag = minLag;
+    float bestScore = score(bestLag);
+    for (double lag = minLag + LagStep; lag <= maxLag; lag += LagStep)
+    {
+        float value = score(lag);
+        if (value > bestScore)
+        {
+            bestScore = value;
+            bestLag = lag;
+        }
+    }
+
+    // Parabola through the peak and its neighbours for the last fraction of a step
+    double lag = bestLag;
+    if (bestLag - LagStep >= minLag && bestLag + LagStep <= maxLag)
+    {
+        float left = score(bestLag - LagStep);
+        float right = score(bestLag + LagStep);
+        float curvature = left - 2.0f * bestScore + right;
+        if (curvature < 0.0f)
+        {
+            lag += 0.5 * LagStep * (left - right) / curvature;
+        }
+    }
+
+    m_confidence = std::min(std::max(correlationAt(lag), 0.0f), 1.0f);
+    if (m_confidence < MinConfidence)
+        return;
+
+    // Small changes are smoothed in; a different tempo has to show up twice in a row
+    const double period = lag / m_frameRate;
+    if (m_period <= 0.0)
+    {
+        m_period = period;
+    }
+    else if (fabs(period - m_period) < m_period * 0.04)
+    {
+        m_period += (period - m_period) * 0.2;
+        m_candidatePeriod = 0.0;
+    }
+    else if (m_candidatePeriod > 0.0 && fabs(period - m_candidatePeriod) < m_candidatePeriod * 0.04)
+    {
+        m_period = period;
+        m_candidatePeriod = 0.0;
+    }
+    else
+    {
+        m_candidatePeriod = period;
+    }
+}
+
+void BeatTracker::EstimatePhase()
+{
+    // Where a comb of beat-spaced taps over the recent novelty sums highest, searched
+    // in half-frame steps over one period back from the newest frame
+    const double periodFrames = m_period * m_frameRate;
+    const size_t count = static_cast<size_t>(std::min<uint64_t>(m_frameCount, m_historySize));
+    const int taps = std::max(static_cast<int>((count - 1) / periodFrames) - 1, 1);
+
+    double bestOffset = 0.0;
+    float bestSum = -1.0f;
+    for (double offset = 0.0; offset < periodFrames; offset += 0.5)
+    {
+        float sum = 0.0f;
+        float weight = 1.0f;
+        for (int tap = 0; tap < taps; ++tap)
+        {
+            sum += GetNovelty(offset + tap * periodFrames) * weight;
+            weight *= 0.85f; // Recent beats count most, so the grid follows tempo drift
+        }
+        if (sum > bestSum)
+        {
+            bestSum = sum;
+            bestOffset = offset;
+        }
+    }
+
+    const double measured = m_lastTime - bestOffset / m_frameRate;
+    if (!m_hasGrid)
+    {
+        m_beatTime = measured;
+        m_hasGrid = true;
+        return;
+    }
+
+    // Phase-locked loop: move the grid part of the way towards the measured beat
+    const double predicted = m_beatTime + floor((measured - m_beatTime) / m_period + 0.5) * m_period;
+    m_beatTime = predicted + (measured - predicted) * PhaseGain;
+}
+
+BeatInfo BeatTracker::GetBeatInfo(double time, double previousTime) const
+{
+    BeatInfo info;
+    if (m_period <= 0.0)
+        return info;
+
+    const double beats = (time - m_beatTime) / m_period;
+    info.phase = static_cast<float>(beats - floor(beats));
+    info.bpm = GetBPM();
+    info.confidence = m_confidence;
+    info.beat = m_confidence >= MinConfidence && time > previousTime &&
+        floor(beats) != floor((previousTime - m_beatTime) / m_period);
+    return info;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "OnsetDetector.h"
+#include "../Utils/Span.h"
+#include <cstdint>
+#include <vector>
+
+// What the visuals see of the beat at one moment
+struct BeatInfo
+{
+    bool beat = false;        // A beat fell between the previous sample time and this one
+    float bpm = 0.0f;         // 0 until a tempo has been found
+    float phase = 0.0f;       // 0 on the beat, rising to 1 just before the next
+    float confidence = 0.0f;  // 0 - 1, how periodic the recent onsets are
+};
+
+// Real-time tempo and beat phase on top of an OnsetDetector. The novelty of the last
+// HistorySeconds is autocorrelated every TempoInterval frames; the period is the
+// (fractional) lag whose first PeriodMultiples multiples correlate best on average,
+// under a log-normal prior around PreferredBPM. The beat grid is then placed where the
+// novelty lines up best with it and followed with a phase-locked loop, so the grid can
+// be extrapolated to the playback time between analysis frames.
+// Not thread safe.
+class BeatTracker
+{
+public:
+    BeatTracker(float minBPM = 60.0f, float maxBPM = 180.0f);
+
+    // Clears all history; 'frameRate' is the number of spectra per second
+    void Reset(double frameRate);
+
+    // One spectrum of the frame centred at 'time' seconds; consecutive calls must be
+    // 1 / frameRate apart
+    void Process(Span<const float> magnitudes, double time);
+
+    // Beat state at 'time' (seconds, same clock as Process). 'previousTime' is the
+    // time of the last call, for the beat flag.
+    BeatInfo GetBeatInfo(double time, double previousTime) const;
+
+    float GetBPM() const { return m_period > 0.0 ? static_cast<float>(60.0 / m_period) : 0.0f; }
+    float GetConfidence() const { return m_confidence; }
+    const OnsetDetector& GetOnsetDetector() const { return m_onsets; }
+
+    static constexpr float HistorySeconds = 6.0f;
+    static constexpr int TempoInterval = 4;       // Frames between tempo estimates
+    static constexpr int PeriodMultiples = 4;
+    static constexpr double LagStep = 0.25;       // Frames between scored periods
+    static constexpr float PreferredBPM = 120.0f;
+    static constexpr float PriorWidth = 0.8f;     // Octaves (standard deviation)
+    static constexpr float PhaseGain = 0.25f;     // Share of the phase error corrected per estimate
+    static constexpr float MinConfidence = 0.1f;  // Below this no beats are reported
+
+private:
+    void EstimateTempo();
+    void EstimatePhase();
+    float GetNovelty(double framesBack) const;
+
+    float m_minBPM;
+    float m_maxBPM;
+    double m_frameRate;
+    OnsetDetector m_onsets;
+
+    // Novelty history; every value is written twice, 'size' apart, so the last 'size'
+    // frames are one contiguous span ending at m_writePos + size
+    std::vector<float> m_history;
+    size_t m_historySize;
+    size_t m_writePos;
+    uint64_t m_frameCount;
+    double m_lastTime;
+
+    std::vector<float> m_smoothed; // Scratch for EstimateTempo
+    std::vector<float> m_autocorrelation;
+    double m_period;         // Seconds per beat, 0 until found
+    double m_candidatePeriod; // A different period seen once; adopted if seen again
+    double m_beatTime;       // Any beat of the current grid
+    bool m_hasGrid;
+    float m_confidence;
+};
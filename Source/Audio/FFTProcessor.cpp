@@ -1,128 +1,704 @@
 #include "FFTProcessor.h"
+#include "PCMConvert.h"
+#include "../Utils/ThreadPool.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <emmintrin.h>
+
+#ifndef MUSICVISUALIZER_NO_FFTW
+#include <fftw3.h>
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-FFTProcessor::FFTProcessor(int fftSize)
-    : m_fftSize(fftSize), m_input(nullptr), m_output(nullptr), m_plan(nullptr)
+namespace
 {
-    InitializeFFTW();
+#ifndef MUSICVISUALIZER_NO_FFTW
+    // The FFTW planner is not thread safe, and fftw_cleanup() invalidates every plan,
+    // so both are serialised and cleanup waits for the last plan. A background measure
+    // holds the planner for a long time, so callers that must not wait only try it.
+    std::mutex s_plannerMutex;
+    std::atomic<int> s_livePlans(0); // Includes background planning tasks; reaches zero under s_plannerMutex
+    bool s_wisdomChanged = false;    // Guarded by s_plannerMutex
+
+    // Caller holds s_plannerMutex
+    void ReleasePlanner()
+    {
+        if (--s_livePlans == 0)
+        {
+            fftwf_cleanup();
+        }
+    }
+
+    // Plans on scratch arrays, since FFTW_MEASURE overwrites its buffers while it times
+    // candidates. The result is run through fftwf_execute_dft_r2c on the caller's arrays,
+    // which fftwf_alloc gives the same alignment. Caller holds s_plannerMutex.
+    fftwf_plan MeasurePlan(int fftSize)
+    {
+        float* input = fftwf_alloc_real(fftSize);
+        fftwf_complex* output = fftwf_alloc_complex(fftSize / 2 + 1);
+
+        fftwf_plan plan = fftwf_plan_dft_r2c_1d(fftSize, input, output, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+        if (!plan)
+        {
+            auto measureStart = std::chrono::steady_clock::now();
+            plan = fftwf_plan_dft_r2c_1d(fftSize, input, output, FFTW_MEASURE);
+            std::chrono::duration<double, std::milli> measureTime = std::chrono::steady_clock::now() - measureStart;
+
+            s_wisdomChanged = true;
+            std::cout << "FFT plan measured: " << fftSize << " points in " << measureTime.count() << " ms" << std::endl;
+        }
+
+        fftwf_free(input);
+        fftwf_free(output);
+        return plan;
+    }
+#endif
+
+    // Plans by size and requested backend. Entries are weak, so a plan is destroyed (and
+    // with the last one FFTW's planner state) once no processor holds it.
+    std::mutex s_planCacheMutex;
+    std::map<std::pair<int, FFTBackend>, std::weak_ptr<const FFTPlan>> s_planCache;
+
+    // RealFFT scratch for the calling thread, grown to the largest size it has run
+    float* GetThreadScratch(size_t size)
+    {
+        thread_local AlignedVector<float> scratch;
+        if (scratch.size() < size)
+        {
+            scratch.resize(size);
+        }
+        return scratch.data();
+    }
+
+    // Floor for the dB output; keeps log10 away from zero and denormals
+    const float MinPower = 1e-20f; // -200 dB
+
+    // log2 of 4 positive normal floats. The mantissa is folded into [sqrt(0.5), sqrt(2))
+    // and log2 comes from the atanh series in t = (m - 1) / (m + 1), |t| <= 0.172, which
+    // is accurate to ~1e-7 with five terms.
+    inline __m128 Log2SSE(__m128 x)
+    {
+        __m128i bits = _mm_castps_si128(x);
+        __m128i exponent = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+        __m128 mantissa = _mm_or_ps(_mm_castsi128_ps(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF))), _mm_set1_ps(1.0f));
+
+        __m128 fold = _mm_cmpgt_ps(mantissa, _mm_set1_ps(1.41421356f));
+        mantissa = _mm_sub_ps(mantissa, _mm_and_ps(fold, _mm_mul_ps(mantissa, _mm_set1_ps(0.5f))));
+        __m128 exponentF = _mm_add_ps(_mm_cvtepi32_ps(exponent), _mm_and_ps(fold, _mm_set1_ps(1.0f)));
+
+        __m128 t = _mm_div_ps(_mm_sub_ps(mantissa, _mm_set1_ps(1.0f)), _mm_add_ps(mantissa, _mm_set1_ps(1.0f)));
+        __m128 t2 = _mm_mul_ps(t, t);
+        __m128 series = _mm_set1_ps(1.0f / 9.0f);
+        series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f / 7.0f));
+        series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f / 5.0f));
+        series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f / 3.0f));
+        series = _mm_add_ps(_mm_mul_ps(series, t2), _mm_set1_ps(1.0f));
+
+        const __m128 twoOverLn2 = _mm_set1_ps(2.88539008f);
+        return _mm_add_ps(exponentF, _mm_mul_ps(_mm_mul_ps(series, t), twoOverLn2));
+    }
+
+    // atan2 for 4 lanes via a degree-9 odd polynomial on [0, 1] (max error ~1e-5 rad)
+    inline __m128 Atan2SSE(__m128 y, __m128 x)
+    {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 absX = _mm_andnot_ps(signMask, x);
+        __m128 absY = _mm_andnot_ps(signMask, y);
+
+        __m128 larger = _mm_max_ps(absX, absY);
+        __m128 smaller = _mm_min_ps(absX, absY);
+        __m128 a = _mm_div_ps(smaller, _mm_max_ps(larger, _mm_set1_ps(1e-30f)));
+        __m128 s = _mm_mul_ps(a, a);
+
+        __m128 r = _mm_set1_ps(0.0208351f);
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.0851330f));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.1801410f));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.3302995f));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.9998660f));
+        r = _mm_mul_ps(r, a);
+
+        // Undo the octant folding: swap axes, then left half-plane, then the sign of y
+        __m128 swapped = _mm_cmpgt_ps(absY, absX);
+        r = _mm_or_ps(_mm_and_ps(swapped, _mm_sub_ps(_mm_set1_ps(1.57079633f), r)), _mm_andnot_ps(swapped, r));
+        __m128 negativeX = _mm_cmplt_ps(x, _mm_setzero_ps());
+        r = _mm_or_ps(_mm_and_ps(negativeX, _mm_sub_ps(_mm_set1_ps(3.14159265f), r)), _mm_andnot_ps(negativeX, r));
+        return _mm_xor_ps(r, _mm_and_ps(y, signMask));
+    }
+}
+
+std::shared_ptr<const FFTPlan> FFTPlan::Get(int fftSize, FFTBackend backend)
+{
+    const std::pair<int, FFTBackend> key(fftSize, backend);
+    {
+        std::lock_guard<std::mutex> lock(s_planCacheMutex);
+        if (std::shared_ptr<const FFTPlan> plan = s_planCache[key].lock())
+            return plan;
+    }
+
+    // Planned outside the cache lock, so lookups of other sizes never wait on the planner
+    std::shared_ptr<FFTPlan> plan(new FFTPlan(fftSize, backend));
+    {
+        std::lock_guard<std::mutex> lock(s_planCacheMutex);
+        std::weak_ptr<const FFTPlan>& entry = s_planCache[key];
+
+        // Another thread planned the same size meanwhile: share that one and drop this
+        if (std::shared_ptr<const FFTPlan> existing = entry.lock())
+            return existing;
+        entry = plan;
+    }
+
+#ifndef MUSICVISUALIZER_NO_FFTW
+    if (plan->m_measuring)
+    {
+        // Measure in the background rather than blocking the caller; the estimated plan
+        // (or the built-in transform) runs until the measured one is published. The task
+        // only holds the plan while it measures, so it never delays its destruction.
+        s_livePlans++;
+
+        std::weak_ptr<FFTPlan> pending = plan;
+        ThreadPool::GetShared().Submit([pending, fftSize]()
+        {
+            // Declared before the lock so a last release destroys the plan after unlocking
+            std::shared_ptr<FFTPlan> target = pending.lock();
+            {
+                std::lock_guard<std::mutex> plannerLock(s_plannerMutex);
+                if (target)
+                {
+                    target->m_measuredPlan.store(MeasurePlan(fftSize), std::memory_order_release);
+                }
+                ReleasePlanner();
+            }
+            if (target)
+            {
+                target->m_measuring = false;
+            }
+        });
+    }
+#endif
+
+    return plan;
+}
+
+FFTPlan::FFTPlan(int fftSize, FFTBackend backend)
+    : m_fftSize(fftSize), m_backend(backend), m_estimatedPlan(nullptr), m_measuredPlan(nullptr), m_measuring(false)
+{
+    bool planned = backend == FFTBackend::FFTW && InitializeFFTW();
+    if (!planned && RealFFT::IsSupportedSize(m_fftSize))
+    {
+        m_realFFT = std::make_unique<RealFFT>(m_fftSize);
+        m_backend = FFTBackend::BuiltIn;
+        planned = true;
+    }
+    if (!planned && backend == FFTBackend::BuiltIn && InitializeFFTW())
+    {
+        m_backend = FFTBackend::FFTW;
+        planned = true;
+    }
+
+    if (!planned)
+    {
+        std::cout << "No FFT backend available for " << m_fftSize << " points" << std::endl;
+    }
+    else if (m_backend != backend)
+    {
+        std::cout << FFTProcessor::GetBackendName(backend) << " FFT unavailable for " << m_fftSize << " points, using "
+            << FFTProcessor::GetBackendName(m_backend) << std::endl;
+    }
+}
+
+FFTPlan::~FFTPlan()
+{
+#ifndef MUSICVISUALIZER_NO_FFTW
+    // Every FFTW-backed plan holds the planner, even while the built-in transform stands in
+    if (m_backend != FFTBackend::FFTW || !IsValid())
+        return;
+
+    fftwf_plan_s* measured = m_measuredPlan.load();
+    std::lock_guard<std::mutex> lock(s_plannerMutex);
+    if (measured)
+    {
+        fftwf_destroy_plan(measured);
+    }
+    if (m_estimatedPlan)
+    {
+        fftwf_destroy_plan(m_estimatedPlan);
+    }
+    ReleasePlanner();
+#endif
+}
+
+bool FFTPlan::InitializeFFTW()
+{
+#ifdef MUSICVISUALIZER_NO_FFTW
+    return false;
+#else
+    // While a background measure holds the planner, run the built-in transform instead of
+    // waiting; the measuring task Get() queues for this plan then plans it from wisdom or
+    // measures it after the current one
+    std::unique_lock<std::mutex> lock(s_plannerMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+    {
+        if (RealFFT::IsSupportedSize(m_fftSize))
+        {
+            m_realFFT = std::make_unique<RealFFT>(m_fftSize);
+            m_measuring = true;
+            s_livePlans++;
+            return true;
+        }
+        lock.lock();
+    }
+
+    // Planned on scratch arrays and executed on the caller's through the new-array
+    // interface; fftwf_alloc gives the same alignment as the callers' buffers
+    float* input = fftwf_alloc_real(m_fftSize);
+    fftwf_complex* output = fftwf_alloc_complex(m_fftSize / 2 + 1);
+
+    // Measured plan from wisdom if there is one; otherwise an estimated plan for now
+    fftwf_plan plan = fftwf_plan_dft_r2c_1d(m_fftSize, input, output, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+    if (plan)
+    {
+        m_measuredPlan.store(plan);
+    }
+    else
+    {
+        m_estimatedPlan = fftwf_plan_dft_r2c_1d(m_fftSize, input, output, FFTW_ESTIMATE);
+        m_measuring = m_estimatedPlan != nullptr;
+    }
+
+    fftwf_free(input);
+    fftwf_free(output);
+
+    if (!plan && !m_estimatedPlan)
+        return false;
+
+    s_livePlans++;
+    return true;
+#endif
+}
+
+void FFTPlan::Execute(float* input, FFTComplex* output) const
+{
+#ifndef MUSICVISUALIZER_NO_FFTW
+    fftwf_plan_s* plan = m_measuredPlan.load(std::memory_order_acquire);
+    if (!plan)
+    {
+        plan = m_estimatedPlan;
+    }
+    if (plan)
+    {
+        fftwf_execute_dft_r2c(plan, input, reinterpret_cast<fftwf_complex*>(output));
+        return;
+    }
+#endif
+
+    if (m_realFFT)
+    {
+        m_realFFT->Forward(input, output, GetThreadScratch(m_realFFT->GetScratchSize()));
+        return;
+    }
+
+    memset(output, 0, GetBinCount() * sizeof(FFTComplex));
+}
+
+FFTProcessor::FFTProcessor(int fftSize, FFTBackend backend)
+    : m_fftSize(fftSize), m_planTime(0.0)
+{
+    auto planStart = std::chrono::steady_clock::now();
+
+    // Input and output are per processor for either backend (single precision is plenty for display)
+    m_input.resize(m_fftSize);
+    m_output.resize(static_cast<size_t>(GetBinCount()) * 2);
+
+    m_plan = FFTPlan::Get(m_fftSize, backend);
+    m_window = WindowFunction::Get(WindowType::Hann, m_fftSize);
+
+    std::chrono::duration<double> planTime = std::chrono::steady_clock::now() - planStart;
+    m_planTime = planTime.count();
 }
 
 FFTProcessor::~FFTProcessor()
 {
-    CleanupFFTW();
 }
 
-void FFTProcessor::InitializeFFTW()
+bool FFTProcessor::IsBackendAvailable(FFTBackend backend)
 {
-    // Allocate FFTW arrays
-    m_input = fftw_alloc_real(m_fftSize);
-    m_output = fftw_alloc_complex(m_fftSize / 2 + 1);
+#ifdef MUSICVISUALIZER_NO_FFTW
+    return backend == FFTBackend::BuiltIn;
+#else
+    (void)backend;
+    return true;
+#endif
+}
+
+const char* FFTProcessor::GetBackendName(FFTBackend backend)
+{
+    return backend == FFTBackend::FFTW ? "FFTW" : "built-in";
+}
 
-    // Create FFTW plan
-    m_plan = fftw_plan_dft_r2c_1d(m_fftSize, m_input, m_output, FFTW_MEASURE);
+FFTBackend FFTProcessor::GetDefaultBackend()
+{
+    return IsBackendAvailable(FFTBackend::FFTW) ? FFTBackend::FFTW : FFTBackend::BuiltIn;
+}
 
-    // Generate Hann window
-    m_window.resize(m_fftSize);
-    for (int i = 0; i < m_fftSize; ++i)
+bool FFTProcessor::ImportWisdom(const std::string& filename)
+{
+#ifdef MUSICVISUALIZER_NO_FFTW
+    (void)filename;
+    return false;
+#else
+    // Read through the stream so non-ASCII paths work; FFTW's own file API takes a narrow path
+    std::ifstream file(std::filesystem::u8path(filename), std::ios::binary);
+    if (!file.is_open())
+        return false;
+
+    std::stringstream contents;
+    contents << file.rdbuf();
+
+    std::lock_guard<std::mutex> lock(s_plannerMutex);
+    if (!fftwf_import_wisdom_from_string(contents.str().c_str()))
     {
-        m_window[i] = 0.5f * (1.0f - cosf(2.0f * 3.14159265359f * i / (m_fftSize - 1)));
+        std::cout << "Ignoring unreadable FFTW wisdom: " << filename << std::endl;
+        return false;
     }
+
+    std::cout << "FFTW wisdom imported: " << filename << std::endl;
+    return true;
+#endif
 }
 
-void FFTProcessor::CleanupFFTW()
+bool FFTProcessor::ExportWisdom(const std::string& filename)
 {
-    if (m_plan)
+#ifdef MUSICVISUALIZER_NO_FFTW
+    (void)filename;
+    return true;
+#else
+    char* wisdom = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(s_plannerMutex);
+        if (!s_wisdomChanged)
+            return true;
+
+        wisdom = fftwf_export_wisdom_to_string();
+        s_wisdomChanged = false;
+    }
+
+    if (!wisdom)
+        return false;
+
+    std::error_code error;
+    std::filesystem::path path = std::filesystem::u8path(filename);
+    std::filesystem::create_directories(path.parent_path(), error);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << wisdom;
+    free(wisdom);
+
+    if (!file.good())
     {
-        fftw_destroy_plan(m_plan);
-        m_plan = nullptr;
+        std::cout << "Failed to write FFTW wisdom: " << filename << std::endl;
+        return false;
     }
 
-    if (m_input)
+    std::cout << "FFTW wisdom exported: " << filename << std::endl;
+    return true;
+#endif
+}
+
+void FFTProcessor::PreparePlans(const std::vector<int>& fftSizes)
+{
+#ifdef MUSICVISUALIZER_NO_FFTW
+    (void)fftSizes;
+#else
+    for (int fftSize : fftSizes)
     {
-        fftw_free(m_input);
-        m_input = nullptr;
+        s_livePlans++;
+        ThreadPool::GetShared().Submit([fftSize]()
+        {
+            std::lock_guard<std::mutex> lock(s_plannerMutex);
+            if (fftwf_plan plan = MeasurePlan(fftSize))
+            {
+                fftwf_destroy_plan(plan);
+            }
+            ReleasePlanner();
+        });
     }
+#endif
+}
+
+float FFTProcessor::ComputeMagnitudes(const FFTComplex* bins, int binCount, float* magnitudes)
+{
+    const float* values = &bins[0][0];
+    float maxPower = 0.0f;
+    int i = 0;
 
-    if (m_output)
+    if (PCMConvert::GetActiveLevel() != SIMDLevel::Scalar)
     {
-        fftw_free(m_output);
-        m_output = nullptr;
+        __m128 maxPower4 = _mm_setzero_ps();
+        for (; i + 4 <= binCount; i += 4)
+        {
+            __m128 low = _mm_loadu_ps(values + i * 2);
+            __m128 high = _mm_loadu_ps(values + i * 2 + 4);
+            __m128 real = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 imag = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+            __m128 power = _mm_add_ps(_mm_mul_ps(real, real), _mm_mul_ps(imag, imag));
+            maxPower4 = _mm_max_ps(maxPower4, power);
+            _mm_storeu_ps(magnitudes + i, _mm_sqrt_ps(power));
+        }
+
+        float lanes[4];
+        _mm_storeu_ps(lanes, maxPower4);
+        maxPower = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
     }
 
-    fftw_cleanup();
+    for (; i < binCount; ++i)
+    {
+        float power = values[i * 2] * values[i * 2] + values[i * 2 + 1] * values[i * 2 + 1];
+        maxPower = std::max(maxPower, power);
+        magnitudes[i] = sqrtf(power);
+    }
+
+    return sqrtf(maxPower);
 }
 
 FFTResult FFTProcessor::ProcessFFT(const std::vector<float>& audioData)
 {
     FFTResult result;
+    ProcessFFT(Span<const float>(audioData), result, FFTOutputFlags::Magnitude | FFTOutputFlags::Phase);
+    return result;
+}
+
+void FFTProcessor::ProcessFFT(Span<const float> input, FFTResult& result, FFTOutputFlags outputs)
+{
+    // No-ops after the first frame: the vectors keep their size and capacity
+    const size_t binCount = GetBinCount();
+    result.magnitudes.resize(HasFlag(outputs, FFTOutputFlags::Magnitude) ? binCount : 0);
+    result.power.resize(HasFlag(outputs, FFTOutputFlags::Power) ? binCount : 0);
+    result.decibels.resize(HasFlag(outputs, FFTOutputFlags::Decibels) ? binCount : 0);
+    result.phases.resize(HasFlag(outputs, FFTOutputFlags::Phase) ? binCount : 0);
+    result.complex.resize(HasFlag(outputs, FFTOutputFlags::Complex) ? binCount * 2 : 0);
     result.sampleCount = m_fftSize;
-    result.maxMagnitude = 0.0f;
 
-    // Prepare input data
-    std::vector<float> processData = audioData;
+    FFTOutputBuffers buffers;
+    buffers.magnitudes = result.magnitudes;
+    buffers.power = result.power;
+    buffers.decibels = result.decibels;
+    buffers.phases = result.phases;
+    buffers.complex = result.complex;
+
+    Process(input, outputs, buffers);
+    result.maxMagnitude = buffers.maxMagnitude;
+}
+
+bool FFTProcessor::Process(Span<const float> input, Span<float> magnitudes, Span<float> phases, float& maxMagnitude)
+{
+    FFTOutputBuffers buffers;
+    buffers.magnitudes = magnitudes;
+    buffers.phases = phases;
+
+    FFTOutputFlags outputs = phases.empty() ? FFTOutputFlags::Magnitude : FFTOutputFlags::Magnitude | FFTOutputFlags::Phase;
+    bool processed = Process(input, outputs, buffers);
+    maxMagnitude = buffers.maxMagnitude;
+    return processed;
+}
+
+bool FFTProcessor::Process(Span<const float> input, FFTOutputFlags outputs, FFTOutputBuffers& buffers)
+{
+    const size_t binCount = GetBinCount();
+    buffers.maxMagnitude = 0.0f;
 
-    // Pad or truncate to FFT size
-    if (processData.size() < m_fftSize)
+    if ((HasFlag(outputs, FFTOutputFlags::Magnitude) && buffers.magnitudes.size() < binCount) ||
+        (HasFlag(outputs, FFTOutputFlags::Power) && buffers.power.size() < binCount) ||
+        (HasFlag(outputs, FFTOutputFlags::Decibels) && buffers.decibels.size() < binCount) ||
+        (HasFlag(outputs, FFTOutputFlags::Phase) && buffers.phases.size() < binCount) ||
+        (HasFlag(outputs, FFTOutputFlags::Complex) && buffers.complex.size() < binCount * 2))
     {
-        processData.resize(m_fftSize, 0.0f);
+        return false;
     }
-    else if (processData.size() > m_fftSize)
+
+    // Window while copying into the plan's buffer; pad with zeros or truncate to the FFT size
+    m_window->Apply(input.data(), input.size(), m_input.data());
+
+    // Execute FFT
+    m_plan->Execute(m_input.data(), reinterpret_cast<FFTComplex*>(m_output.data()));
+
+    ComputeOutputs(outputs, buffers);
+    return true;
+}
+
+void FFTProcessor::ComputeOutputs(FFTOutputFlags outputs, FFTOutputBuffers& buffers) const
+{
+    const int binCount = GetBinCount();
+    const bool wantMagnitude = HasFlag(outputs, FFTOutputFlags::Magnitude);
+    const bool wantPower = HasFlag(outputs, FFTOutputFlags::Power);
+    const bool wantDecibels = HasFlag(outputs, FFTOutputFlags::Decibels);
+    const bool wantPhase = HasFlag(outputs, FFTOutputFlags::Phase);
+
+    if (HasFlag(outputs, FFTOutputFlags::Complex))
     {
-        processData.resize(m_fftSize);
+        memcpy(buffers.complex.data(), m_output.data(), binCount * sizeof(FFTComplex));
     }
 
-    // Apply window function
-    ApplyWindow(processData);
+    const float* bins = m_output.data();
+    float maxPower = 0.0f;
+    int i = 0;
 
-    // Copy to FFTW input array
-    for (int i = 0; i < m_fftSize; ++i)
+    if (PCMConvert::GetActiveLevel() != SIMDLevel::Scalar)
     {
-        m_input[i] = static_cast<double>(processData[i]);
+        __m128 maxPower4 = _mm_setzero_ps();
+
+        for (; i + 4 <= binCount; i += 4)
+        {
+            __m128 low = _mm_loadu_ps(bins + i * 2);      // re0 im0 re1 im1
+            __m128 high = _mm_loadu_ps(bins + i * 2 + 4); // re2 im2 re3 im3
+            __m128 real = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+            __m128 imag = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+            __m128 power = _mm_add_ps(_mm_mul_ps(real, real), _mm_mul_ps(imag, imag));
+            maxPower4 = _mm_max_ps(maxPower4, power);
+
+            if (wantPower)
+                _mm_storeu_ps(&buffers.power[i], power);
+            if (wantMagnitude)
+                _mm_storeu_ps(&buffers.magnitudes[i], _mm_sqrt_ps(power));
+            if (wantDecibels)
+            {
+                // 10 * log10(p) = 10 * log10(2) * log2(p)
+                __m128 log2 = Log2SSE(_mm_max_ps(power, _mm_set1_ps(MinPower)));
+                _mm_storeu_ps(&buffers.decibels[i], _mm_mul_ps(log2, _mm_set1_ps(3.01029996f)));
+            }
+            if (wantPhase)
+                _mm_storeu_ps(&buffers.phases[i], Atan2SSE(imag, real));
+        }
+
+        float lanes[4];
+        _mm_storeu_ps(lanes, maxPower4);
+        maxPower = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
     }
 
-    // Execute FFT
-    fftw_execute(m_plan);
+    // Scalar path and the tail (the Nyquist bin for power-of-two sizes)
+    for (; i < binCount; ++i)
+    {
+        float real = bins[i * 2];
+        float imag = bins[i * 2 + 1];
+        float power = real * real + imag * imag;
+        maxPower = std::max(maxPower, power);
+
+        if (wantPower)
+            buffers.power[i] = power;
+        if (wantMagnitude)
+            buffers.magnitudes[i] = sqrtf(power);
+        if (wantDecibels)
+            buffers.decibels[i] = 10.0f * log10f(std::max(power, MinPower));
+        if (wantPhase)
+            buffers.phases[i] = atan2f(imag, real);
+    }
+
+    buffers.maxMagnitude = sqrtf(maxPower);
+}
+
+void FFTProcessor::ApplyWindow(std::vector<float>& data)
+{
+    m_window->ApplyInPlace(data.data(), data.size());
+}
 
-    // Calculate magnitudes and phases
-    int outputSize = m_fftSize / 2 + 1;
-    result.magnitudes.resize(outputSize);
-    result.phases.resize(outputSize);
+void FFTProcessor::SetWindow(WindowType type, float parameter)
+{
+    m_window = WindowFunction::Get(type, m_fftSize, parameter);
+}
 
-    for (int i = 0; i < outputSize; ++i)
+FFTBatchPlan::FFTBatchPlan(int fftSize, int batchSize, FFTBackend backend)
+    : m_fftSize(fftSize), m_batchSize(batchSize), m_plan(nullptr)
+{
+#ifndef MUSICVISUALIZER_NO_FFTW
+    // A busy planner means a background measure; the built-in transform runs the frames
+    // instead of waiting for it
+    std::unique_lock<std::mutex> lock(s_plannerMutex, std::defer_lock);
+    if (backend == FFTBackend::FFTW && (lock.try_lock() || !RealFFT::IsSupportedSize(fftSize)))
     {
-        double real = m_output[i][0];
-        double imag = m_output[i][1];
+        if (!lock.owns_lock())
+        {
+            lock.lock();
+        }
 
-        // Calculate magnitude
-        result.magnitudes[i] = static_cast<float>(sqrt(real * real + imag * imag));
+        // Frames are packed back to back: input distance fftSize, output distance fftSize / 2 + 1
+        const int binCount = fftSize / 2 + 1;
+        float* input = fftwf_alloc_real(static_cast<size_t>(fftSize) * batchSize);
+        fftwf_complex* output = fftwf_alloc_complex(static_cast<size_t>(binCount) * batchSize);
 
-        // Calculate phase
-        result.phases[i] = static_cast<float>(atan2(imag, real));
+        m_plan = fftwf_plan_many_dft_r2c(1, &m_fftSize, batchSize, input, nullptr, 1, fftSize,
+            output, nullptr, 1, binCount, FFTW_MEASURE | FFTW_WISDOM_ONLY);
+        if (!m_plan)
+        {
+            auto measureStart = std::chrono::steady_clock::now();
+            m_plan = fftwf_plan_many_dft_r2c(1, &m_fftSize, batchSize, input, nullptr, 1, fftSize,
+                output, nullptr, 1, binCount, FFTW_MEASURE);
+            std::chrono::duration<double, std::milli> measureTime = std::chrono::steady_clock::now() - measureStart;
 
-        // Track maximum magnitude
-        if (result.magnitudes[i] > result.maxMagnitude)
+            s_wisdomChanged = true;
+            std::cout << "FFT batch plan measured: " << batchSize << " x " << fftSize << " points in "
+                << measureTime.count() << " ms" << std::endl;
+        }
+
+        fftwf_free(input);
+        fftwf_free(output);
+
+        if (m_plan)
         {
-            result.maxMagnitude = result.magnitudes[i];
+            s_livePlans++;
+            return;
         }
     }
+#else
+    (void)backend;
+#endif
 
-    return result;
+    if (RealFFT::IsSupportedSize(fftSize))
+    {
+        m_realFFT = std::make_unique<RealFFT>(fftSize);
+    }
 }
 
-void FFTProcessor::ApplyWindow(std::vector<float>& data)
+FFTBatchPlan::~FFTBatchPlan()
 {
-    ApplyHannWindow(data);
+#ifndef MUSICVISUALIZER_NO_FFTW
+    if (m_plan)
+    {
+        std::lock_guard<std::mutex> lock(s_plannerMutex);
+        fftwf_destroy_plan(m_plan);
+        ReleasePlanner();
+    }
+#endif
 }
 
-void FFTProcessor::ApplyHannWindow(std::vector<float>& data)
+void FFTBatchPlan::Execute(float* input, FFTComplex* output) const
 {
-    for (size_t i = 0; i < data.size() && i < m_window.size(); ++i)
+    if (m_realFFT)
     {
-        data[i] *= m_window[i];
+        // One scratch buffer per calling thread keeps Execute() thread safe
+        float* scratch = GetThreadScratch(m_realFFT->GetScratchSize());
+
+        const int binCount = GetBinCount();
+        for (int frame = 0; frame < m_batchSize; ++frame)
+        {
+            m_realFFT->Forward(input + static_cast<size_t>(frame) * m_fftSize,
+                output + static_cast<size_t>(frame) * binCount, scratch);
+        }
+        return;
     }
-}
\ No newline at end of file
+
+#ifndef MUSICVISUALIZER_NO_FFTW
+    fftwf_execute_dft_r2c(m_plan, input, reinterpret_cast<fftwf_complex*>(output));
+#endif
+}
@@ -1,35 +1,205 @@
 #pragma once
+#include "RealFFT.h"
+#include "WindowFunction.h"
+#include "../Utils/AlignedAllocator.h"
+#include "../Utils/Span.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 #include <complex>
-#include <fftw3.h>
+
+// FFTW stays out of this header so the project also builds without it
+// (MUSICVISUALIZER_NO_FFTW), in which case only the built-in transform exists
+struct fftwf_plan_s;
+
+enum class FFTBackend
+{
+    FFTW,    // Planned FFTW transforms, when built in
+    BuiltIn  // RealFFT: power-of-two sizes from 256 to 65536
+};
+
+// Which spectra a Process call computes; anything not requested is skipped entirely
+enum class FFTOutputFlags : uint32_t
+{
+    None      = 0,
+    Magnitude = 1 << 0, // |X|
+    Power     = 1 << 1, // |X|^2
+    Decibels  = 1 << 2, // 10 * log10(|X|^2), floored at FFTProcessor::MinDecibels
+    Phase     = 1 << 3, // atan2(im, re) in radians
+    Complex   = 1 << 4  // Raw bins, interleaved re/im
+};
+
+inline FFTOutputFlags operator|(FFTOutputFlags a, FFTOutputFlags b)
+{
+    return static_cast<FFTOutputFlags>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+}
+
+inline bool HasFlag(FFTOutputFlags flags, FFTOutputFlags flag)
+{
+    return (static_cast<uint32_t>(flags) & static_cast<uint32_t>(flag)) != 0;
+}
+
+// Caller-owned destinations. Each requested output needs GetBinCount() floats, twice
+// that for Complex; outputs that were not requested may be left empty.
+struct FFTOutputBuffers
+{
+    Span<float> magnitudes;
+    Span<float> power;
+    Span<float> decibels;
+    Span<float> phases;
+    Span<float> complex;
+    float maxMagnitude = 0.0f; // Always filled
+};
 
 struct FFTResult
 {
-    std::vector<float> magnitudes;
-    std::vector<float> phases;
+    AlignedVector<float> magnitudes;
+    AlignedVector<float> phases;   // Only filled when FFTOutputFlags::Phase was requested
+    AlignedVector<float> power;
+    AlignedVector<float> decibels;
+    AlignedVector<float> complex;
     int sampleCount;
     float maxMagnitude;
 };
 
+// Single-frame real-to-complex plan, shared by every processor of one size and backend.
+// Immutable once built except for the background FFTW_MEASURE upgrade, so Execute() is
+// thread safe and lock free: callers pass their own buffers and the built-in backend
+// uses per-thread scratch.
+class FFTPlan
+{
+public:
+    // Cached by size and requested backend while any holder keeps the plan alive. Falls
+    // back to the other backend when the requested one is not built in, does not support
+    // the size or fails to plan. Does not wait for a background measure of another size
+    // unless the built-in transform cannot stand in for this one.
+    static std::shared_ptr<const FFTPlan> Get(int fftSize, FFTBackend backend);
+    ~FFTPlan();
+
+    FFTPlan(const FFTPlan&) = delete;
+    FFTPlan& operator=(const FFTPlan&) = delete;
+
+    bool IsValid() const { return m_estimatedPlan != nullptr || m_measuredPlan.load() != nullptr || m_realFFT != nullptr; }
+    FFTBackend GetBackend() const { return m_backend; }
+    int GetFFTSize() const { return m_fftSize; }
+    int GetBinCount() const { return m_fftSize / 2 + 1; }
+
+    // False while an FFTW plan is still being measured in the background
+    bool IsMeasured() const { return !m_measuring.load(std::memory_order_relaxed); }
+
+    // 'input' holds fftSize samples, 'output' GetBinCount() bins; both 64-byte aligned
+    void Execute(float* input, FFTComplex* output) const;
+
+private:
+    FFTPlan(int fftSize, FFTBackend backend);
+    bool InitializeFFTW();
+
+    int m_fftSize;
+    FFTBackend m_backend;
+    fftwf_plan_s* m_estimatedPlan;               // Kept until destruction: other threads may still run it
+    std::atomic<fftwf_plan_s*> m_measuredPlan;   // Preferred once set (from wisdom or the background task)
+    std::atomic<bool> m_measuring;
+    std::unique_ptr<RealFFT> m_realFFT;          // Built-in backend, or FFTW's stand-in while the planner was busy
+};
+
+// Windowing, transform and output pass for one stream. The plan is shared (FFTPlan::Get),
+// so a processor is just its buffers and window: give each thread its own to analyse
+// several tracks or channels at once.
 class FFTProcessor
 {
 public:
-    FFTProcessor(int fftSize = 4096);
+    FFTProcessor(int fftSize = 4096, FFTBackend backend = GetDefaultBackend());
     ~FFTProcessor();
 
+    // Convenience path with magnitudes and phases; allocates a new result on every call
     FFTResult ProcessFFT(const std::vector<float>& audioData);
+
+    // Allocation-free path. Windows 'input' (zero padded or truncated to the FFT size)
+    // straight into the plan's input buffer and computes only the requested outputs, in
+    // one SIMD pass over the bins. Returns false if a requested output is too small.
+    bool Process(Span<const float> input, FFTOutputFlags outputs, FFTOutputBuffers& buffers);
+
+    // Magnitudes plus optional phases ('phases' may be empty)
+    bool Process(Span<const float> input, Span<float> magnitudes, Span<float> phases, float& maxMagnitude);
+
+    // Into a result that is reused across frames; its vectors only grow once
+    void ProcessFFT(Span<const float> input, FFTResult& result, FFTOutputFlags outputs = FFTOutputFlags::Magnitude);
+
     void ApplyWindow(std::vector<float>& data);
 
     int GetFFTSize() const { return m_fftSize; }
+    int GetBinCount() const { return m_fftSize / 2 + 1; }
+
+    static constexpr float MinDecibels = -200.0f;
+
+    // Window applied to every frame (Hann unless changed), GetFFTSize() entries
+    const WindowTable& GetWindow() const { return *m_window; }
+    void SetWindow(WindowType type, float parameter = 0.0f);
+
+    // |X| for 'binCount' bins into 'magnitudes'; returns the largest magnitude
+    static float ComputeMagnitudes(const FFTComplex* bins, int binCount, float* magnitudes);
+
+    FFTBackend GetBackend() const { return m_plan->GetBackend(); }
+    static bool IsBackendAvailable(FFTBackend backend);
+    static const char* GetBackendName(FFTBackend backend);
+
+    // Backend for processors created without an explicit choice: FFTW when built in
+    static FFTBackend GetDefaultBackend();
+
+    // Seconds the constructor spent getting its plan (near zero when it was cached); the
+    // FFTW_MEASURE plan may still be pending
+    double GetPlanTime() const { return m_planTime; }
+    bool IsPlanMeasured() const { return m_plan->IsMeasured(); }
+
+    // FFTW wisdom keeps measured plans across runs. Export is skipped when nothing new
+    // was measured since the last import or export.
+    static bool ImportWisdom(const std::string& filename);
+    static bool ExportWisdom(const std::string& filename);
+
+    // Measures plans for these sizes on the shared thread pool, so processors created
+    // later get them straight from wisdom. Returns without waiting for the planner.
+    static void PreparePlans(const std::vector<int>& fftSizes);
 
 private:
-    void InitializeFFTW();
-    void CleanupFFTW();
-    void ApplyHannWindow(std::vector<float>& data);
+    void ComputeOutputs(FFTOutputFlags outputs, FFTOutputBuffers& buffers) const;
 
     int m_fftSize;
-    double* m_input;
-    fftw_complex* m_output;
-    fftw_plan m_plan;
-    std::vector<float> m_window;
-};
\ No newline at end of file
+    AlignedVector<float> m_input;
+    AlignedVector<float> m_output; // GetBinCount() interleaved complex bins
+    std::shared_ptr<const FFTPlan> m_plan;
+    double m_planTime;
+    std::shared_ptr<const WindowTable> m_window; // Shared through WindowFunction's registry
+};
+
+// Batched real-to-complex plan for 'batchSize' back-to-back frames of one size
+// (fftwf_plan_many_dft_r2c), created through the same serialised planner as
+// FFTPlan. With the built-in backend the frames run one by one through RealFFT.
+// Execute() is thread safe: every caller passes its own buffers, allocated with
+// fftwf_alloc or another 64-byte aligned allocator.
+class FFTBatchPlan
+{
+public:
+    FFTBatchPlan(int fftSize, int batchSize, FFTBackend backend = FFTProcessor::GetDefaultBackend());
+    ~FFTBatchPlan();
+
+    FFTBatchPlan(const FFTBatchPlan&) = delete;
+    FFTBatchPlan& operator=(const FFTBatchPlan&) = delete;
+
+    bool IsValid() const { return m_plan != nullptr || m_realFFT != nullptr; }
+    FFTBackend GetBackend() const { return m_realFFT ? FFTBackend::BuiltIn : FFTBackend::FFTW; }
+
+    // 'input' holds batchSize * fftSize samples, 'output' batchSize * GetBinCount() bins
+    void Execute(float* input, FFTComplex* output) const;
+
+    int GetFFTSize() const { return m_fftSize; }
+    int GetBatchSize() const { return m_batchSize; }
+    int GetBinCount() const { return m_fftSize / 2 + 1; }
+
+private:
+    int m_fftSize;
+    int m_batchSize;
+    fftwf_plan_s* m_plan;
+    std::unique_ptr<RealFFT> m_realFFT;
+};
@@ -3,7 +3,7 @@
 #include <cmath>
 
 FrequencyAnalyzer::FrequencyAnalyzer()
-    : m_smoothingFactor(0.8f), m_initialized(false)
+    : m_front(0), m_hasFrame(false), m_weighting(BandWeighting::Rectangular), m_smoothingFactor(0.8f)
 {
 }
 
@@ -11,157 +11,169 @@ FrequencyAnalyzer::~FrequencyAnalyzer()
 {
 }
 
-std::vector<FrequencyBand> FrequencyAnalyzer::AnalyzeFrequencies(const FFTResult& fftResult, int sampleRate)
+BandView FrequencyAnalyzer::AnalyzeFrequencies(const FFTResult& fftResult, int sampleRate)
 {
-    if (!m_initialized)
-    {
-        InitializeFrequencyBands(fftResult.sampleCount, sampleRate);
-        m_initialized = true;
-    }
-
-    // Update amplitude values for each frequency band
-    for (auto& band : m_frequencyBands)
-    {
-        float totalAmplitude = 0.0f;
-        int binCount = 0;
+    EnsureFrequencyBands(fftResult.sampleCount, sampleRate);
 
-        // Sum amplitudes across the frequency band's bin range
-        for (int bin = band.binStart; bin <= band.binEnd && bin < fftResult.magnitudes.size(); ++bin)
-        {
-            totalAmplitude += fftResult.magnitudes[bin];
-            binCount++;
-        }
-
-        // Calculate average amplitude for this band
-        if (binCount > 0)
-        {
-            band.amplitude = totalAmplitude / binCount;
-
-            // Normalize by max magnitude to get 0-1 range
-            if (fftResult.maxMagnitude > 0.0f)
-            {
-                band.amplitude /= fftResult.maxMagnitude;
-            }
-
-            // Clamp to [0, 1]
-            band.amplitude = std::clamp(band.amplitude, 0.0f, 1.0f);
-        }
-        else
-        {
-            band.amplitude = 0.0f;
-        }
-    }
+    // Weighted mean of every band's bins in one pass over the spectrum, straight into
+    // the back buffer
+    m_table->GetWeights().Apply(fftResult.magnitudes, m_buffers[1 - m_front].amplitudes);
+    NormalizeAmplitudes(fftResult.maxMagnitude);
 
-    // Apply smoothing for animation
-    SmoothAmplitudes(m_frequencyBands);
+    FinishFrame();
+    return GetBands();
+}
 
-    return m_frequencyBands;
+BandView FrequencyAnalyzer::AnalyzeBandMagnitudes(Span<const float> magnitudes, float maxMagnitude, int sampleRate)
+{
+    // Bin ranges stay those of the last spectrum (or the default size); only the
+    // amplitudes come from 'magnitudes'
+    EnsureFrequencyBands(m_table ? m_table->GetFFTSize() : 4096, sampleRate);
+
+    AlignedVector<float>& amplitudes = m_buffers[1 - m_front].amplitudes;
+    const size_t count = std::min(magnitudes.size(), amplitudes.size());
+    std::copy(magnitudes.begin(), magnitudes.begin() + count, amplitudes.begin());
+    std::fill(amplitudes.begin() + count, amplitudes.end(), 0.0f);
+    NormalizeAmplitudes(maxMagnitude);
+
+    FinishFrame();
+    return GetBands();
 }
 
-void FrequencyAnalyzer::InitializeFrequencyBands(int fftSize, int sampleRate)
+BandView FrequencyAnalyzer::GetBands() const
 {
-    m_frequencyBands.clear();
+    BandView view;
+    if (!m_hasFrame || !m_table)
+        return view;
+
+    const BandBuffers& front = m_buffers[m_front];
+    view.frequencies = m_table->GetFrequencies();
+    view.amplitudes = front.amplitudes;
+    view.smoothedAmplitudes = front.smoothedAmplitudes;
+    view.peaks = front.peaks;
+    return view;
+}
 
-    // Define frequency ranges
-    struct FrequencyRange
-    {
-        float minFreq;
-        float maxFreq;
-        const char* name;
-    };
-
-    std::vector<FrequencyRange> ranges = {
-        {20.0f, 60.0f, "SubBass"},
-        {60.0f, 250.0f, "Bass"},
-        {250.0f, 500.0f, "LowMid"},
-        {500.0f, 2000.0f, "Mid"},
-        {2000.0f, 4000.0f, "HighMid"},
-        {4000.0f, 6000.0f, "Presence"},
-        {6000.0f, 20000.0f, "Brilliance"}
-    };
-
-    // Create frequency bands
-    for (const auto& range : ranges)
+void FrequencyAnalyzer::NormalizeAmplitudes(float maxMagnitude)
+{
+    // Normalize by max magnitude to get 0-1 range
+    AlignedVector<float>& amplitudes = m_buffers[1 - m_front].amplitudes;
+    const float scale = maxMagnitude > 0.0f ? 1.0f / maxMagnitude : 1.0f;
+    for (size_t i = 0; i < amplitudes.size(); ++i)
     {
-        FrequencyBand band;
-        band.frequency = (range.minFreq + range.maxFreq) * 0.5f; // Center frequency
-        band.binStart = FrequencyToBin(range.minFreq, fftSize, sampleRate);
-        band.binEnd = FrequencyToBin(range.maxFreq, fftSize, sampleRate);
-        band.amplitude = 0.0f;
-        band.smoothedAmplitude = 0.0f;
-
-        // Ensure valid bin ranges
-        band.binStart = (band.binStart > 0) ? band.binStart : 0;
-        band.binEnd = (band.binEnd < fftSize / 2) ? band.binEnd : fftSize / 2;
-
-        if (band.binStart <= band.binEnd)
-        {
-            m_frequencyBands.push_back(band);
-        }
+        amplitudes[i] = std::min(std::max(amplitudes[i] * scale, 0.0f), 1.0f);
     }
+}
 
-    // Add additional fine-grained bands for more detailed visualization
-    int numDetailBands = 16;
-    float minLogFreq = log10f(80.0f);   // Start from 80 Hz
-    float maxLogFreq = log10f(8000.0f); // Up to 8 kHz
-    float logStep = (maxLogFreq - minLogFreq) / numDetailBands;
+void FrequencyAnalyzer::FinishFrame()
+{
+    const BandBuffers& front = m_buffers[m_front];
+    BandBuffers& back = m_buffers[1 - m_front];
 
-    for (int i = 0; i < numDetailBands; ++i)
+    // Exponential smoothing for animation and a decaying peak hold; plain loops over
+    // contiguous arrays, which the compiler vectorises
+    const float smoothing = m_smoothingFactor;
+    for (size_t i = 0; i < back.amplitudes.size(); ++i)
     {
-        float logFreq1 = minLogFreq + i * logStep;
-        float logFreq2 = minLogFreq + (i + 1) * logStep;
+        back.smoothedAmplitudes[i] = smoothing * front.smoothedAmplitudes[i] + (1.0f - smoothing) * back.amplitudes[i];
+        back.peaks[i] = std::max(back.amplitudes[i], front.peaks[i] * PeakDecay);
+    }
 
-        float freq1 = powf(10.0f, logFreq1);
-        float freq2 = powf(10.0f, logFreq2);
+    m_front = 1 - m_front;
+    m_hasFrame = true;
+}
 
-        FrequencyBand band;
-        band.frequency = (freq1 + freq2) * 0.5f;
-        band.binStart = FrequencyToBin(freq1, fftSize, sampleRate);
-        band.binEnd = FrequencyToBin(freq2, fftSize, sampleRate);
-        band.amplitude = 0.0f;
-        band.smoothedAmplitude = 0.0f;
+const BandWeightMatrix& FrequencyAnalyzer::GetBandWeights() const
+{
+    static const BandWeightMatrix empty;
+    return m_table ? m_table->GetWeights() : empty;
+}
 
-        // Ensure valid bin ranges
-        band.binStart = (band.binStart > 0) ? band.binStart : 0;
-        band.binEnd = (band.binEnd < fftSize / 2) ? band.binEnd : fftSize / 2;
+std::vector<int> FrequencyAnalyzer::GetBandBins(int fftSize, int sampleRate)
+{
+    EnsureFrequencyBands(fftSize, sampleRate);
 
-        if (band.binStart <= band.binEnd)
+    std::vector<int> bins;
+    const BandWeightMatrix& weights = GetBandWeights();
+    for (size_t band = 0; band < weights.GetBandCount(); ++band)
+    {
+        const int firstBin = weights.GetFirstBin(band);
+        for (int bin = firstBin; bin < firstBin + weights.GetBinCount(band); ++bin)
         {
-            m_frequencyBands.push_back(band);
+            bins.push_back(bin);
         }
     }
+
+    std::sort(bins.begin(), bins.end());
+    bins.erase(std::unique(bins.begin(), bins.end()), bins.end());
+    return bins;
 }
 
-int FrequencyAnalyzer::FrequencyToBin(float frequency, int fftSize, int sampleRate)
+void FrequencyAnalyzer::SetBandWeighting(BandWeighting weighting)
 {
-    return static_cast<int>((frequency * fftSize) / sampleRate);
+    if (weighting == m_weighting)
+        return;
+
+    m_weighting = weighting;
+    if (m_table)
+    {
+        EnsureFrequencyBands(m_table->GetFFTSize(), m_table->GetSampleRate());
+    }
 }
 
-float FrequencyAnalyzer::BinToFrequency(int bin, int fftSize, int sampleRate)
+void FrequencyAnalyzer::SetBandLayout(const BandLayout& layout)
 {
-    return (static_cast<float>(bin) * sampleRate) / fftSize;
+    if (layout == m_layout)
+        return;
+
+    m_layout = layout;
+    if (m_table)
+    {
+        EnsureFrequencyBands(m_table->GetFFTSize(), m_table->GetSampleRate());
+    }
 }
 
-void FrequencyAnalyzer::SmoothAmplitudes(std::vector<FrequencyBand>& bands)
+void FrequencyAnalyzer::EnsureFrequencyBands(int fftSize, int sampleRate)
 {
-    for (auto& band : bands)
+    if (m_table && m_table->Matches(m_layout, m_weighting, fftSize, sampleRate))
+        return;
+
+    // A new spectrum size, rate or weighting brings the same bands back in the same
+    // order, so the buffers keep their values and smoothing carries over; a new layout
+    // means different bands, which start from zero
+    const bool sameBands = m_table && m_table->GetLayout() == m_layout;
+    m_table = BandTable::Get(m_layout, m_weighting, fftSize, sampleRate);
+
+    const size_t bandCount = m_table ? m_table->GetBandCount() : 0;
+    for (BandBuffers& buffers : m_buffers)
     {
-        // Exponential smoothing
-        band.smoothedAmplitude = m_smoothingFactor * band.smoothedAmplitude +
-            (1.0f - m_smoothingFactor) * band.amplitude;
+        if (!sameBands)
+        {
+            buffers.amplitudes.clear();
+            buffers.smoothedAmplitudes.clear();
+            buffers.peaks.clear();
+        }
+        buffers.amplitudes.resize(bandCount, 0.0f);
+        buffers.smoothedAmplitudes.resize(bandCount, 0.0f);
+        buffers.peaks.resize(bandCount, 0.0f);
     }
 }
 
 float FrequencyAnalyzer::GetBassLevel() const
 {
+    if (!m_table)
+        return 0.0f;
+
     float bassLevel = 0.0f;
     int count = 0;
 
-    for (const auto& band : m_frequencyBands)
+    const AlignedVector<float>& smoothed = m_buffers[m_front].smoothedAmplitudes;
+    const std::vector<float>& frequencies = m_table->GetFrequencies();
+    for (size_t i = 0; i < frequencies.size(); ++i)
     {
-        if (band.frequency >= 60.0f && band.frequency <= 250.0f)
+        if (frequencies[i] >= 60.0f && frequencies[i] <= 250.0f)
         {
-            bassLevel += band.smoothedAmplitude;
+            bassLevel += smoothed[i];
             count++;
         }
     }
@@ -171,14 +183,19 @@ float FrequencyAnalyzer::GetBassLevel() const
 
 float FrequencyAnalyzer::GetMidLevel() const
 {
+    if (!m_table)
+        return 0.0f;
+
     float midLevel = 0.0f;
     int count = 0;
 
-    for (const auto& band : m_frequencyBands)
+    const AlignedVector<float>& smoothed = m_buffers[m_front].smoothedAmplitudes;
+    const std::vector<float>& frequencies = m_table->GetFrequencies();
+    for (size_t i = 0; i < frequencies.size(); ++i)
     {
-        if (band.frequency >= 250.0f && band.frequency <= 4000.0f)
+        if (frequencies[i] >= 250.0f && frequencies[i] <= 4000.0f)
         {
-            midLevel += band.smoothedAmplitude;
+            midLevel += smoothed[i];
             count++;
         }
     }
@@ -188,14 +205,19 @@ float FrequencyAnalyzer::GetMidLevel() const
 
 float FrequencyAnalyzer::GetTrebleLevel() const
 {
+    if (!m_table)
+        return 0.0f;
+
     float trebleLevel = 0.0f;
     int count = 0;
 
-    for (const auto& band : m_frequencyBands)
+    const AlignedVector<float>& smoothed = m_buffers[m_front].smoothedAmplitudes;
+    const std::vector<float>& frequencies = m_table->GetFrequencies();
+    for (size_t i = 0; i < frequencies.size(); ++i)
     {
-        if (band.frequency >= 4000.0f)
+        if (frequencies[i] >= 4000.0f)
         {
-            trebleLevel += band.smoothedAmplitude;
+            trebleLevel += smoothed[i];
             count++;
         }
     }
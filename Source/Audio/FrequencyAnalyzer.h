@@ -1,16 +1,10 @@
 #pragma once
+#include "BandLayout.h"
+#include "BandView.h"
+#include "BandWeightMatrix.h"
 #include "FFTProcessor.h"
 #include <vector>
 
-struct FrequencyBand
-{
-    float amplitude;      // 0.0 - 1.0
-    float frequency;      // Center frequency in Hz
-    float smoothedAmplitude; // Smoothed for animation
-    int binStart;         // Starting FFT bin
-    int binEnd;           // Ending FFT bin
-};
-
 enum class FrequencyRange
 {
     SubBass,    // 20-60 Hz
@@ -28,21 +22,65 @@ public:
     FrequencyAnalyzer();
     ~FrequencyAnalyzer();
 
-    std::vector<FrequencyBand> AnalyzeFrequencies(const FFTResult& fftResult, int sampleRate);
+    // Band values for one spectrum, written into the analyzer's own arrays (no per-frame
+    // allocation); the view stays valid through the next call
+    BandView AnalyzeFrequencies(const FFTResult& fftResult, int sampleRate);
+
+    // Same bands from per-band magnitudes (one per GetBandEdges() entry), e.g. from
+    // MultiResolutionSpectrum; 'maxMagnitude' normalises them like a spectrum's peak
+    BandView AnalyzeBandMagnitudes(Span<const float> magnitudes, float maxMagnitude, int sampleRate);
+
+    // Latest frame (empty before the first analysis)
+    BandView GetBands() const;
+
+    // Bin ranges of the bands for the current spectrum size
+    const BandWeightMatrix& GetBandWeights() const;
+
+    // Which bands to analyse. Tables are shared per (layout, weighting, size, rate), so
+    // switching to a combination seen before swaps tables instead of rebuilding one;
+    // the band values restart from zero when the layout changes.
+    void SetBandLayout(const BandLayout& layout);
+    const BandLayout& GetBandLayout() const { return m_layout; }
+
+    // Frequency ranges of the bands, in band order
+    std::vector<BandEdges> GetBandEdges() const { return m_layout.GetEdges(); }
+
+    // Sorted FFT bins the bands read for this size and rate (band edges inclusive)
+    std::vector<int> GetBandBins(int fftSize, int sampleRate);
     void SetSmoothingFactor(float factor) { m_smoothingFactor = factor; }
 
+    // How bins are weighted into bands; takes effect on the next spectrum
+    void SetBandWeighting(BandWeighting weighting);
+    BandWeighting GetBandWeighting() const { return m_weighting; }
+
     // Get specific frequency ranges
     float GetBassLevel() const;
     float GetMidLevel() const;
     float GetTrebleLevel() const;
 
 private:
-    void InitializeFrequencyBands(int fftSize, int sampleRate);
-    int FrequencyToBin(float frequency, int fftSize, int sampleRate);
-    float BinToFrequency(int bin, int fftSize, int sampleRate);
-    void SmoothAmplitudes(std::vector<FrequencyBand>& bands);
+    void EnsureFrequencyBands(int fftSize, int sampleRate);
+    void NormalizeAmplitudes(float maxMagnitude);
+    void FinishFrame();
+
+    // Per-frame values, one contiguous array each. A frame is computed into the back
+    // buffer from the front one (smoothing and peaks need the previous values), then
+    // the two swap, so the previous view stays readable while the next is written.
+    struct BandBuffers
+    {
+        AlignedVector<float> amplitudes;
+        AlignedVector<float> smoothedAmplitudes;
+        AlignedVector<float> peaks;
+    };
+
+    BandBuffers m_buffers[2];
+    int m_front;
+    bool m_hasFrame;
 
-    std::vector<FrequencyBand> m_frequencyBands;
+    // Requested layout and the table compiled for the last spectrum's size and rate
+    BandLayout m_layout;
+    BandWeighting m_weighting;
+    std::shared_ptr<const BandTable> m_table;
     float m_smoothingFactor;
-    bool m_initialized;
+    static constexpr float PeakDecay = 0.95f; // Per analysed frame
 };
\ No newline at end of file
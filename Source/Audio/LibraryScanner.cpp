@@ -0,0 +1,110 @@
+#include "LibraryScanner.h"
+#include "../Utils/ThreadPool.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+
+namespace
+{
+    bool IsWAVExtension(const std::filesystem::path& path)
+    {
+        std::string extension = path.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".wav";
+    }
+}
+
+LibraryScanner::LibraryScanner()
+    : m_failedCount(0), m_lastScanTime(0.0)
+{
+}
+
+bool LibraryScanner::ScanDirectory(const std::string& directory, std::vector<LibraryEntry>& entries, bool recursive)
+{
+    entries.clear();
+    m_failedCount = 0;
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(std::filesystem::u8path(directory), error))
+    {
+        std::cout << "Not a directory: " << directory << std::endl;
+        return false;
+    }
+
+    auto scanStart = std::chrono::steady_clock::now();
+
+    std::vector<std::string> paths;
+    CollectFiles(directory, recursive, paths);
+    std::sort(paths.begin(), paths.end());
+
+    // Every file probes into its own slot, so the workers share nothing but the loader,
+    // which keeps no per-call state
+    std::vector<LibraryEntry> probed(paths.size());
+    std::vector<char> valid(paths.size(), 0);
+
+    ThreadPool::GetShared().ParallelFor(paths.size(), 8,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                probed[i].path = paths[i];
+                valid[i] = m_loader.ProbeWAVFile(paths[i], probed[i].info) ? 1 : 0;
+            }
+        });
+
+    entries.reserve(paths.size());
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        if (valid[i])
+        {
+            entries.push_back(std::move(probed[i]));
+        }
+        else
+        {
+            m_failedCount++;
+        }
+    }
+
+    std::chrono::duration<double> scanTime = std::chrono::steady_clock::now() - scanStart;
+    m_lastScanTime = scanTime.count();
+
+    std::cout << "Library scan: " << entries.size() << " tracks, " << m_failedCount << " unreadable, "
+        << m_lastScanTime * 1000.0 << " ms" << std::endl;
+
+    return true;
+}
+
+void LibraryScanner::CollectFiles(const std::string& directory, bool recursive, std::vector<std::string>& paths) const
+{
+    // Unreadable subfolders are skipped rather than aborting the whole scan
+    std::error_code error;
+    auto options = std::filesystem::directory_options::skip_permission_denied;
+
+    auto addEntry = [&](const std::filesystem::directory_entry& entry)
+    {
+        if (entry.is_regular_file(error) && IsWAVExtension(entry.path()))
+        {
+            paths.push_back(entry.path().u8string());
+        }
+    };
+
+    if (recursive)
+    {
+        for (std::filesystem::recursive_directory_iterator it(std::filesystem::u8path(directory), options, error), end;
+            it != end; it.increment(error))
+        {
+            addEntry(*it);
+        }
+    }
+    else
+    {
+        for (std::filesystem::directory_iterator it(std::filesystem::u8path(directory), options, error), end;
+            it != end; it.increment(error))
+        {
+            addEntry(*it);
+        }
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "AudioLoader.h"
+#include <string>
+#include <vector>
+
+struct LibraryEntry
+{
+    std::string path; // UTF-8
+    WAVInfo info;
+};
+
+// Builds a track list for a folder by probing WAV headers only. Files are probed on the
+// shared thread pool, so a large library costs a few small reads per file instead of a
+// full decode.
+class LibraryScanner
+{
+public:
+    LibraryScanner();
+
+    // Replaces 'entries' with every readable .wav under 'directory', sorted by path.
+    // Returns false only when the directory itself cannot be listed.
+    bool ScanDirectory(const std::string& directory, std::vector<LibraryEntry>& entries, bool recursive = true);
+
+    size_t GetFailedCount() const { return m_failedCount; } // Files that looked like WAVs but did not parse
+    double GetLastScanTime() const { return m_lastScanTime; } // Seconds
+
+private:
+    void CollectFiles(const std::string& directory, bool recursive, std::vector<std::string>& paths) const;
+
+    AudioLoader m_loader;
+    size_t m_failedCount;
+    double m_lastScanTime;
+};
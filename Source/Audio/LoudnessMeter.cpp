@@ -0,0 +1,358 @@
+#include "LoudnessMeter.h"
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace
+{
+    // Zeroth-order modified Bessel function of the first kind, for the Kaiser window
+    double BesselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; k++)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12)
+                break;
+        }
+        return sum;
+    }
+
+    const double Pi = 3.14159265358979323846;
+
+    // True-peak interpolator: windowed sinc cut off just below the input Nyquist
+    const double InterpolatorCutoff = 0.46; // Of the input rate
+    const double InterpolatorBeta = 6.0;
+
+    // MXCSR flush-to-zero and denormals-are-zero: the filter state decays into
+    // denormals after silence, which would slow every following sample
+    const unsigned int FlushDenormals = 0x8040;
+}
+
+LoudnessMeter::LoudnessMeter()
+    : m_sampleRate(0), m_channelCount(0), m_groupCount(0), m_oversampling(1),
+      m_shelf(), m_highPass(), m_interpolatorGain(1.0f), m_stepFrames(1), m_framesInStep(0), m_stepPos(0), m_stepCount(0)
+{
+    Reset(48000, 2);
+}
+
+void LoudnessMeter::Reset(int sampleRate, int channelCount)
+{
+    m_sampleRate = std::max(sampleRate, 1);
+    m_channelCount = std::max(channelCount, 0);
+    m_groupCount = (m_channelCount + 3) / 4;
+    m_oversampling = m_sampleRate < 96000 ? 4 : m_sampleRate < 192000 ? 2 : 1;
+
+    // K-weighting from the BS.1770 analog prototype (matches the published 48 kHz
+    // coefficients, and holds at other rates): a +4 dB high shelf around 1.7 kHz...
+    {
+        const double f0 = 1681.974450955533;
+        const double gain = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = tan(Pi * f0 / m_sampleRate);
+        const double vh = pow(10.0, gain / 20.0);
+        const double vb = pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        m_shelf.b0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+        m_shelf.b1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+        m_shelf.b2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+        m_shelf.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        m_shelf.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+
+    // ...then the RLB high-pass at 38 Hz
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = tan(Pi * f0 / m_sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        m_highPass.b0 = 1.0f;
+        m_highPass.b1 = -2.0f;
+        m_highPass.b2 = 1.0f;
+        m_highPass.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        m_highPass.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+
+    const size_t lanes = static_cast<size_t>(m_groupCount) * 4;
+    m_weights.assign(lanes, 0.0f);
+    std::fill(m_weights.begin(), m_weights.begin() + m_channelCount, 1.0f);
+    if (m_channelCount == 6)
+    {
+        m_weights[3] = 0.0f;
+        m_weights[4] = 1.41f;
+        m_weights[5] = 1.41f;
+    }
+
+    m_filterState.assign(lanes * 4, 0.0f);
+    m_peakHistory.assign(static_cast<size_t>(m_channelCount) * (InterpolatorTaps - 1), 0.0f);
+
+    // Phase p (1 .. L-1) interpolates p / L of the way between the two middle taps of
+    // the window; phase 0 is the sample itself, which the sample peak already covers.
+    // Each phase is normalised to unity gain at DC. At 4x the reading stays within
+    // -0.32 / +0.01 dB of the sine's peak up to 16 kHz at 48 kHz (the under-read is
+    // what 4x sampling of the peak itself allows).
+    const int phases = m_oversampling - 1;
+    m_interpolatorGain = 1.0f;
+    m_interpolator.assign(static_cast<size_t>(phases) * InterpolatorTaps * 4, 0.0f);
+    const double halfWidth = InterpolatorTaps * 0.5;
+    const double windowScale = 1.0 / BesselI0(InterpolatorBeta);
+    for (int phase = 0; phase < phases; ++phase)
+    {
+        double coefficients[InterpolatorTaps];
+        double sum = 0.0;
+        for (int tap = 0; tap < InterpolatorTaps; ++tap)
+        {
+            double t = tap - (halfWidth - 1.0) - static_cast<double>(phase + 1) / m_oversampling;
+            double sinc = t == 0.0 ? 2.0 * InterpolatorCutoff : sin(2.0 * Pi * InterpolatorCutoff * t) / (Pi * t);
+            double ratio = t / halfWidth;
+            coefficients[tap] = sinc * BesselI0(InterpolatorBeta * sqrt(std::max(0.0, 1.0 - ratio * ratio))) * windowScale;
+            sum += coefficients[tap];
+        }
+
+        float* row = &m_interpolator[static_cast<size_t>(phase) * InterpolatorTaps * 4];
+        float gain = 0.0f;
+        for (int tap = 0; tap < InterpolatorTaps; ++tap)
+        {
+            std::fill(row + tap * 4, row + tap * 4 + 4, static_cast<float>(coefficients[tap] / sum));
+            gain += fabsf(row[tap * 4]);
+        }
+        m_interpolatorGain = std::max(m_interpolatorGain, gain);
+    }
+
+    m_stepSquares.assign(lanes, 0.0);
+    m_blockSquares.assign(lanes, 0.0);
+    m_blockPeak.assign(lanes, 0.0f);
+    m_stepFrames = std::max(static_cast<size_t>(m_sampleRate * StepSeconds + 0.5f), static_cast<size_t>(1));
+    m_framesInStep = 0;
+
+    m_stepPower.assign(ShortTermSteps, 0.0);
+    m_stepPos = 0;
+    m_stepCount = 0;
+
+    m_levels = LoudnessLevels();
+    m_channelRMS.assign(m_channelCount, 0.0f);
+    m_channelTruePeak.assign(m_channelCount, 0.0f);
+}
+
+void LoudnessMeter::Process(const float* const* channels, size_t frameCount)
+{
+    if (m_channelCount == 0 || frameCount == 0)
+        return;
+
+    const unsigned int csr = _mm_getcsr();
+    _mm_setcsr(csr | FlushDenormals);
+
+    std::fill(m_blockSquares.begin(), m_blockSquares.end(), 0.0);
+    std::fill(m_blockPeak.begin(), m_blockPeak.end(), 0.0f);
+
+    // Split the block at step boundaries so every step's sum is complete
+    size_t done = 0;
+    while (done < frameCount)
+    {
+        size_t count = std::min(frameCount - done, m_stepFrames - m_framesInStep);
+        for (int group = 0; group < m_groupCount; ++group)
+        {
+            ProcessGroup(group, channels, done, count);
+        }
+
+        m_framesInStep += count;
+        done += count;
+        if (m_framesInStep == m_stepFrames)
+        {
+            CompleteStep();
+        }
+    }
+
+    // After the sample peaks, which the true-peak pass starts from
+    for (int channel = 0; channel < m_channelCount; ++channel)
+    {
+        if (m_oversampling > 1)
+        {
+            ProcessTruePeak(channel, channels[channel], frameCount);
+        }
+        else
+        {
+            m_channelTruePeak[channel] = m_blockPeak[channel];
+        }
+    }
+
+    _mm_setcsr(csr);
+
+    double power = 0.0;
+    m_levels.samplePeak = 0.0f;
+    m_levels.truePeak = 0.0f;
+    for (int channel = 0; channel < m_channelCount; ++channel)
+    {
+        double meanSquare = m_blockSquares[channel] / frameCount;
+        power += meanSquare;
+        m_channelRMS[channel] = static_cast<float>(sqrt(meanSquare));
+        m_levels.samplePeak = std::max(m_levels.samplePeak, m_blockPeak[channel]);
+        m_levels.truePeak = std::max(m_levels.truePeak, m_channelTruePeak[channel]);
+    }
+    m_levels.rms = static_cast<float>(sqrt(power / m_channelCount));
+    m_levels.momentary = GetLoudness(MomentarySteps);
+    m_levels.shortTerm = GetLoudness(ShortTermSteps);
+}
+
+void LoudnessMeter::ProcessGroup(int group, const float* const* channels, size_t offset, size_t frameCount)
+{
+    // Spare lanes of the last group repeat the last channel; their weight is zero and
+    // their levels are never read
+    const float* lanes[4];
+    for (int lane = 0; lane < 4; ++lane)
+    {
+        lanes[lane] = channels[std::min(group * 4 + lane, m_channelCount - 1)] + offset;
+    }
+
+    const __m128 shelfB0 = _mm_set1_ps(m_shelf.b0);
+    const __m128 shelfB1 = _mm_set1_ps(m_shelf.b1);
+    const __m128 shelfB2 = _mm_set1_ps(m_shelf.b2);
+    const __m128 shelfA1 = _mm_set1_ps(m_shelf.a1);
+    const __m128 shelfA2 = _mm_set1_ps(m_shelf.a2);
+    const __m128 highPassA1 = _mm_set1_ps(m_highPass.a1);
+    const __m128 highPassA2 = _mm_set1_ps(m_highPass.a2);
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+    float* state = &m_filterState[group * 16];
+    __m128 shelf1 = _mm_load_ps(state);
+    __m128 shelf2 = _mm_load_ps(state + 4);
+    __m128 highPass1 = _mm_load_ps(state + 8);
+    __m128 highPass2 = _mm_load_ps(state + 12);
+
+    __m128 squares = _mm_setzero_ps();
+    __m128 weightedSquares = _mm_setzero_ps();
+    __m128 peak = _mm_load_ps(&m_blockPeak[group * 4]);
+
+    for (size_t i = 0; i < frameCount; ++i)
+    {
+        const __m128 x = _mm_setr_ps(lanes[0][i], lanes[1][i], lanes[2][i], lanes[3][i]);
+
+        // K-weighting, both stages in transposed direct form II (the high-pass
+        // numerator is 1, -2, 1). The feedback term is applied last so each stage's
+        // recursion is one multiply and one subtract long.
+        const __m128 shelved = _mm_add_ps(_mm_mul_ps(shelfB0, x), shelf1);
+        shelf1 = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(shelfB1, x), shelf2), _mm_mul_ps(shelfA1, shelved));
+        shelf2 = _mm_sub_ps(_mm_mul_ps(shelfB2, x), _mm_mul_ps(shelfA2, shelved));
+
+        const __m128 weighted = _mm_add_ps(shelved, highPass1);
+        highPass1 = _mm_sub_ps(_mm_sub_ps(highPass2, _mm_add_ps(shelved, shelved)), _mm_mul_ps(highPassA1, weighted));
+        highPass2 = _mm_sub_ps(shelved, _mm_mul_ps(highPassA2, weighted));
+
+        squares = _mm_add_ps(squares, _mm_mul_ps(x, x));
+        weightedSquares = _mm_add_ps(weightedSquares, _mm_mul_ps(weighted, weighted));
+        peak = _mm_max_ps(peak, _mm_and_ps(x, absMask));
+    }
+
+    _mm_store_ps(state, shelf1);
+    _mm_store_ps(state + 4, shelf2);
+    _mm_store_ps(state + 8, highPass1);
+    _mm_store_ps(state + 12, highPass2);
+    _mm_store_ps(&m_blockPeak[group * 4], peak);
+
+    // Float sums over at most one step, then doubles across steps and blocks
+    alignas(16) float laneSquares[4];
+    alignas(16) float laneWeighted[4];
+    _mm_store_ps(laneSquares, squares);
+    _mm_store_ps(laneWeighted, weightedSquares);
+    for (int lane = 0; lane < 4; ++lane)
+    {
+        m_blockSquares[group * 4 + lane] += laneSquares[lane];
+        m_stepSquares[group * 4 + lane] += laneWeighted[lane];
+    }
+}
+
+void LoudnessMeter::ProcessTruePeak(int channel, const float* samples, size_t frameCount)
+{
+    // The window of output frame i is input[i .. i + taps), ending with samples[i]; the
+    // interpolated points lie between its two middle samples
+    const size_t historySize = InterpolatorTaps - 1;
+    float* history = &m_peakHistory[static_cast<size_t>(channel) * historySize];
+    m_peakInput.resize(historySize + frameCount + 3);
+    float* input = m_peakInput.data();
+    std::copy(history, history + historySize, input);
+    std::copy(samples, samples + frameCount, input + historySize);
+    std::fill(input + historySize + frameCount, input + historySize + frameCount + 3, 0.0f);
+
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 laneIndex = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 inverseGain = _mm_set1_ps(1.0f / m_interpolatorGain);
+    const int phases = m_oversampling - 1;
+
+    // Highest peak so far in every lane, starting from the sample peak. No output can
+    // exceed the gain times the largest sample under its window, so four frames whose
+    // windows stay below peak / gain are skipped; most of a block usually is.
+    __m128 truePeak = _mm_set1_ps(m_blockPeak[channel]);
+    __m128 threshold = _mm_mul_ps(truePeak, inverseGain);
+
+    for (size_t i = 0; i < frameCount; i += 4)
+    {
+        const __m128 reach = _mm_max_ps(
+            _mm_max_ps(_mm_and_ps(_mm_loadu_ps(input + i), absMask), _mm_and_ps(_mm_loadu_ps(input + i + 4), absMask)),
+            _mm_max_ps(_mm_and_ps(_mm_loadu_ps(input + i + 8), absMask), _mm_and_ps(_mm_loadu_ps(input + i + 11), absMask)));
+        if (_mm_movemask_ps(_mm_cmpgt_ps(reach, threshold)) == 0)
+            continue;
+
+        __m128 magnitude = _mm_setzero_ps();
+        for (int phase = 0; phase < phases; ++phase)
+        {
+            const float* coefficients = &m_interpolator[static_cast<size_t>(phase) * InterpolatorTaps * 4];
+            __m128 sum0 = _mm_mul_ps(_mm_loadu_ps(input + i), _mm_load_ps(coefficients));
+            __m128 sum1 = _mm_mul_ps(_mm_loadu_ps(input + i + 1), _mm_load_ps(coefficients + 4));
+            for (int tap = 2; tap < InterpolatorTaps; tap += 2)
+            {
+                sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(input + i + tap), _mm_load_ps(coefficients + tap * 4)));
+                sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(input + i + tap + 1), _mm_load_ps(coefficients + tap * 4 + 4)));
+            }
+            magnitude = _mm_max_ps(magnitude, _mm_and_ps(_mm_add_ps(sum0, sum1), absMask));
+        }
+
+        // Lanes past the end of the block read the zero padding
+        const __m128 valid = _mm_cmplt_ps(laneIndex, _mm_set1_ps(static_cast<float>(frameCount - i)));
+        magnitude = _mm_and_ps(magnitude, valid);
+        magnitude = _mm_max_ps(magnitude, _mm_shuffle_ps(magnitude, magnitude, _MM_SHUFFLE(2, 3, 0, 1)));
+        magnitude = _mm_max_ps(magnitude, _mm_shuffle_ps(magnitude, magnitude, _MM_SHUFFLE(1, 0, 3, 2)));
+        truePeak = _mm_max_ps(truePeak, magnitude);
+        threshold = _mm_mul_ps(truePeak, inverseGain);
+    }
+
+    m_channelTruePeak[channel] = _mm_cvtss_f32(truePeak);
+
+    std::copy(input + frameCount, input + frameCount + historySize, history);
+}
+
+void LoudnessMeter::CompleteStep()
+{
+    // BS.1770: sum over channels of weight x mean square of the K-weighted signal
+    double power = 0.0;
+    for (size_t lane = 0; lane < m_stepSquares.size(); ++lane)
+    {
+        power += m_weights[lane] * m_stepSquares[lane] / m_stepFrames;
+        m_stepSquares[lane] = 0.0;
+    }
+
+    m_stepPower[m_stepPos] = power;
+    m_stepPos = (m_stepPos + 1) % m_stepPower.size();
+    m_stepCount = std::min(m_stepCount + 1, m_stepPower.size());
+    m_framesInStep = 0;
+}
+
+float LoudnessMeter::GetLoudness(int steps) const
+{
+    // Mean power of the last 'steps' steps (fewer right after a reset)
+    const size_t count = std::min(static_cast<size_t>(steps), m_stepCount);
+    if (count == 0)
+        return MinLoudness;
+
+    double sum = 0.0;
+    for (size_t i = 1; i <= count; ++i)
+    {
+        sum += m_stepPower[(m_stepPos + m_stepPower.size() - i) % m_stepPower.size()];
+    }
+
+    const double power = sum / count;
+    if (power <= 0.0)
+        return MinLoudness;
+    return std::max(static_cast<float>(-0.691 + 10.0 * log10(power)), MinLoudness);
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include "../Utils/AlignedAllocator.h"
+#include <cstddef>
+#include <vector>
+
+// Absolute levels of the signal, for visuals that should follow how loud the music
+// actually is rather than the per-frame normalised spectrum
+struct LoudnessLevels
+{
+    float rms = 0.0f;          // Linear, over the last Process() block, power-averaged over channels
+    float samplePeak = 0.0f;   // Linear, over the last block, loudest channel
+    float truePeak = 0.0f;     // Linear, 4x oversampled (2x at 96 kHz and up)
+    float momentary = -70.0f;  // LUFS over the last 400 ms, floored at MinLoudness
+    float shortTerm = -70.0f;  // LUFS over the last 3 s, floored at MinLoudness
+};
+
+// Streaming time-domain metering per ITU-R BS.1770-4 / EBU R128: sample and true peak,
+// RMS, and K-weighted momentary and short-term loudness. K-weighting is the standard
+// pair of biquads (high shelf, then the RLB high-pass), designed from the analog
+// prototype for any rate. The recursive filters run channels side by side in SSE2
+// lanes, four per register, so stereo costs the same as mono; the true-peak FIR has no
+// recursion and runs four output frames per register instead. Loudness windows move in
+// 100 ms steps; RMS and peaks cover each Process() block.
+// Not thread safe.
+class LoudnessMeter
+{
+public:
+    LoudnessMeter();
+
+    // Clears all state. Channels are weighted as in BS.1770: 1.0 each, except a 5.1
+    // (L R C LFE Ls Rs) file, whose LFE is left out and surrounds count 1.41.
+    void Reset(int sampleRate, int channelCount);
+
+    // Planar input: channel ch is channels[ch][0 .. frameCount)
+    void Process(const float* const* channels, size_t frameCount);
+
+    const LoudnessLevels& GetLevels() const { return m_levels; }
+    float GetChannelRMS(int channel) const { return m_channelRMS[channel]; }
+    float GetChannelTruePeak(int channel) const { return m_channelTruePeak[channel]; }
+
+    int GetSampleRate() const { return m_sampleRate; }
+    int GetChannelCount() const { return m_channelCount; }
+    int GetOversampling() const { return m_oversampling; }
+
+    static constexpr float StepSeconds = 0.1f;
+    static constexpr int MomentarySteps = 4;   // 400 ms
+    static constexpr int ShortTermSteps = 30;  // 3 s
+    static constexpr float MinLoudness = -70.0f; // LUFS; the BS.1770 absolute gate
+    static constexpr int InterpolatorTaps = 12;  // Per phase of the true-peak interpolator
+
+private:
+    struct Biquad
+    {
+        float b0, b1, b2, a1, a2;
+    };
+
+    void ProcessGroup(int group, const float* const* channels, size_t offset, size_t frameCount);
+    void ProcessTruePeak(int channel, const float* samples, size_t frameCount);
+    void CompleteStep();
+    float GetLoudness(int steps) const;
+
+    int m_sampleRate;
+    int m_channelCount;
+    int m_groupCount;   // Four channels per group; spare lanes repeat the last channel
+    int m_oversampling;
+
+    Biquad m_shelf;
+    Biquad m_highPass;
+    std::vector<float> m_weights; // Per lane, 0 for spare lanes
+
+    // Per group, four lanes each: shelf z1, z2 and high-pass z1, z2
+    AlignedVector<float> m_filterState;
+
+    // True peak: per channel the last InterpolatorTaps - 1 samples, scratch holding them
+    // followed by the block, and each phase's coefficients broadcast to four lanes
+    std::vector<float> m_peakHistory;
+    AlignedVector<float> m_peakInput;
+    AlignedVector<float> m_interpolator;
+    float m_interpolatorGain; // Largest sum of |coefficients| over the phases
+
+    // Per lane, over the current 100 ms step and the current Process() block
+    std::vector<double> m_stepSquares;  // K-weighted
+    std::vector<double> m_blockSquares; // Unweighted
+    AlignedVector<float> m_blockPeak;
+    size_t m_stepFrames;
+    size_t m_framesInStep;
+
+    // Weighted mean square of each completed step, newest last in the ring
+    std::vector<double> m_stepPower;
+    size_t m_stepPos;
+    size_t m_stepCount;
+
+    LoudnessLevels m_levels;
+    std::vector<float> m_channelRMS;
+    std::vector<float> m_channelTruePeak;
+};
@@ -0,0 +1,148 @@
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+MappedFile::MappedFile()
+    : m_data(nullptr), m_size(0), m_fileHandle(nullptr), m_mappingHandle(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::string& filename, bool allowMapping)
+{
+    Close();
+
+    if (allowMapping && MapFile(filename))
+    {
+        return true;
+    }
+
+    // Mapping is not available (network share, pipe, platform without mmap):
+    // serve reads from a regular buffered stream instead
+    m_stream.open(std::filesystem::u8path(filename), std::ios::binary);
+    if (!m_stream.is_open())
+    {
+        std::cout << "Failed to open file: " << filename << std::endl;
+        return false;
+    }
+
+    m_stream.seekg(0, std::ios::end);
+    m_size = static_cast<uint64_t>(m_stream.tellg());
+    m_stream.seekg(0, std::ios::beg);
+
+    // Only worth reporting when mapping was wanted and failed
+    if (allowMapping)
+    {
+        std::cout << "File opened with buffered reads (" << m_size << " bytes)" << std::endl;
+    }
+    return true;
+}
+
+bool MappedFile::MapFile(const std::string& filename)
+{
+#ifdef _WIN32
+    int wideSize = MultiByteToWideChar(CP_UTF8, 0, filename.c_str(), -1, nullptr, 0);
+    if (wideSize <= 0) return false;
+
+    std::wstring wideFilename(wideSize - 1, 0);
+    MultiByteToWideChar(CP_UTF8, 0, filename.c_str(), -1, &wideFilename[0], wideSize);
+
+    HANDLE file = CreateFileW(wideFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    m_fileHandle = file;
+    m_mappingHandle = mapping;
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<uint64_t>(fileSize.QuadPart);
+
+    std::cout << "File mapped into memory (" << m_size << " bytes)" << std::endl;
+    return true;
+#else
+    (void)filename;
+    return false;
+#endif
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (m_data)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(m_mappingHandle));
+    }
+    if (m_fileHandle)
+    {
+        CloseHandle(static_cast<HANDLE>(m_fileHandle));
+    }
+#endif
+    m_data = nullptr;
+    m_mappingHandle = nullptr;
+    m_fileHandle = nullptr;
+    m_size = 0;
+
+    if (m_stream.is_open())
+    {
+        m_stream.close();
+    }
+    m_stream.clear();
+}
+
+size_t MappedFile::Read(uint64_t offset, void* destination, size_t bytes) const
+{
+    if (offset >= m_size)
+        return 0;
+
+    size_t available = static_cast<size_t>(std::min<uint64_t>(bytes, m_size - offset));
+
+    if (m_data)
+    {
+        memcpy(destination, m_data + offset, available);
+        return available;
+    }
+
+    std::lock_guard<std::mutex> lock(m_streamMutex);
+    m_stream.clear();
+    m_stream.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+    m_stream.read(static_cast<char*>(destination), static_cast<std::streamsize>(available));
+    return static_cast<size_t>(m_stream.gcount());
+}
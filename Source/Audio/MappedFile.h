@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+// Read-only file access that maps the whole file into memory when the OS allows it
+// and falls back to buffered reads otherwise. Callers that can work on a pointer use
+// GetData(); everything else goes through Read(), which works in both modes.
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // allowMapping = false skips the mapping for callers that only read a few headers
+    bool Open(const std::string& filename, bool allowMapping = true);
+    void Close();
+
+    // Copies up to 'bytes' bytes starting at 'offset', returns the number of bytes read
+    size_t Read(uint64_t offset, void* destination, size_t bytes) const;
+
+    const uint8_t* GetData() const { return m_data; } // nullptr when not mapped
+    uint64_t GetSize() const { return m_size; }
+    bool IsOpen() const { return m_data != nullptr || m_stream.is_open(); }
+    bool IsMapped() const { return m_data != nullptr; }
+
+private:
+    bool MapFile(const std::string& filename);
+
+    const uint8_t* m_data;
+    uint64_t m_size;
+
+    // Native handles, kept as void* so the header stays free of Windows.h
+    void* m_fileHandle;
+    void* m_mappingHandle;
+
+    // Buffered fallback
+    mutable std::ifstream m_stream;
+    mutable std::mutex m_streamMutex;
+};
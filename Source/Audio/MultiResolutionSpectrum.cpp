@@ -0,0 +1,254 @@
+#include "MultiResolutionSpectrum.h"
+#include "WindowFunction.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const double Pi = 3.14159265358979323846;
+
+    // Half-band low-pass (cutoff at a quarter of the input rate), Kaiser windowed. Every
+    // other tap away from the centre is zero, so only the non-zero ones are kept.
+    const int HalfBandTaps = 63;
+    const float HalfBandBeta = 8.0f;
+
+    struct HalfBandFilter
+    {
+        std::vector<int> offsets;
+        std::vector<float> coefficients;
+
+        HalfBandFilter()
+        {
+            std::shared_ptr<const WindowTable> window = WindowFunction::Get(WindowType::Kaiser, HalfBandTaps, HalfBandBeta);
+            const int centre = HalfBandTaps / 2;
+
+            double sum = 0.0;
+            std::vector<double> taps(HalfBandTaps);
+            for (int i = 0; i < HalfBandTaps; ++i)
+            {
+                int n = i - centre;
+                double sinc = n == 0 ? 0.5 : sin(0.5 * Pi * n) / (Pi * n);
+                taps[i] = sinc * (*window)[i];
+                sum += taps[i];
+            }
+
+            for (int i = 0; i < HalfBandTaps; ++i)
+            {
+                if (i == centre || (i - centre) % 2 != 0)
+                {
+                    offsets.push_back(i);
+                    coefficients.push_back(static_cast<float>(taps[i] / sum));
+                }
+            }
+        }
+    };
+
+    const HalfBandFilter& GetHalfBandFilter()
+    {
+        static const HalfBandFilter filter;
+        return filter;
+    }
+}
+
+struct MultiResolutionSpectrum::Tier
+{
+    // Every sample is written twice, 'fftSize' apart, so the latest window is contiguous
+    std::vector<float> history;
+    size_t writePos = 0;
+    int sinceLastFrame = 0;
+    FFTResult result;
+
+    // Decimator feeding the next tier: the last HalfBandTaps - 1 inputs, then the block
+    std::vector<float> filterInput;
+    bool skipNext = false; // Output is taken on every other input sample
+    std::vector<float> decimated;
+};
+
+MultiResolutionSpectrum::MultiResolutionSpectrum(int fftSize, int maxTiers)
+    : m_fftSize(fftSize), m_maxTiers(std::max(maxTiers, 1)), m_sampleRate(48000),
+      m_fft(std::make_unique<FFTProcessor>(fftSize)), m_maxMagnitude(0.0f)
+{
+}
+
+MultiResolutionSpectrum::~MultiResolutionSpectrum()
+{
+}
+
+bool MultiResolutionSpectrum::Configure(int sampleRate, const std::vector<BandEdges>& bands)
+{
+    if (sampleRate <= 0 || m_fftSize < 16)
+        return false;
+
+    m_sampleRate = sampleRate;
+    m_kernels.clear();
+
+    int deepestTier = 0;
+    for (const BandEdges& band : bands)
+    {
+        const float width = band.maxFrequency - band.minFrequency;
+
+        // Shallowest tier with enough bins; deeper tiers only while the band stays
+        // below their alias-free limit
+        int tier = 0;
+        for (int t = 0; t < m_maxTiers; ++t)
+        {
+            double rate = static_cast<double>(sampleRate) / (1 << t);
+            double limit = t == 0 ? rate * 0.5 : rate * AliasFreeLimit;
+            if (t > 0 && band.maxFrequency > limit)
+                break;
+
+            tier = t;
+            if (width / (rate / m_fftSize) >= MinBinsPerBand)
+                break;
+        }
+
+        const double spacing = static_cast<double>(sampleRate) / (1 << tier) / m_fftSize;
+        BandKernel kernel;
+        kernel.tier = tier;
+        kernel.firstBin = static_cast<int>(ceil(band.minFrequency / spacing));
+        int lastBin = std::min(static_cast<int>(floor(band.maxFrequency / spacing)), m_fftSize / 2);
+        if (lastBin < kernel.firstBin)
+        {
+            kernel.firstBin = std::min(static_cast<int>(0.5 * (band.minFrequency + band.maxFrequency) / spacing + 0.5), m_fftSize / 2);
+            lastBin = kernel.firstBin;
+        }
+        kernel.binCount = lastBin - kernel.firstBin + 1;
+
+        m_kernels.push_back(kernel);
+        deepestTier = std::max(deepestTier, tier);
+    }
+
+    m_tiers.clear();
+    for (int t = 0; t <= deepestTier; ++t)
+    {
+        m_tiers.push_back(std::make_unique<Tier>());
+    }
+    m_bandMagnitudes.assign(bands.size(), 0.0f);
+
+    Reset();
+    return true;
+}
+
+void MultiResolutionSpectrum::Reset()
+{
+    for (auto& tier : m_tiers)
+    {
+        tier->history.assign(static_cast<size_t>(m_fftSize) * 2, 0.0f);
+        tier->writePos = 0;
+        tier->sinceLastFrame = 0;
+        tier->result.magnitudes.assign(m_fftSize / 2 + 1, 0.0f);
+        tier->result.maxMagnitude = 0.0f;
+        tier->filterInput.assign(HalfBandTaps - 1, 0.0f);
+        tier->skipNext = false;
+    }
+
+    std::fill(m_bandMagnitudes.begin(), m_bandMagnitudes.end(), 0.0f);
+    m_maxMagnitude = 0.0f;
+}
+
+bool MultiResolutionSpectrum::Push(const float* samples, size_t count)
+{
+    if (m_tiers.empty())
+        return false;
+
+    const HalfBandFilter& filter = GetHalfBandFilter();
+    const int hop = m_fftSize / 4;
+    const size_t windowSize = m_fftSize;
+    bool updated = false;
+
+    for (size_t t = 0; t < m_tiers.size(); ++t)
+    {
+        Tier& tier = *m_tiers[t];
+
+        // Same scheme as STFTProcessor: copy up to the next hop, transform the window
+        const float* input = samples;
+        size_t remaining = count;
+        while (remaining > 0)
+        {
+            size_t block = std::min<size_t>(remaining, hop - tier.sinceLastFrame);
+            block = std::min(block, windowSize - tier.writePos);
+
+            std::copy(input, input + block, tier.history.begin() + tier.writePos);
+            std::copy(input, input + block, tier.history.begin() + tier.writePos + windowSize);
+            tier.writePos = (tier.writePos + block) % windowSize;
+            tier.sinceLastFrame += static_cast<int>(block);
+            input += block;
+            remaining -= block;
+
+            if (tier.sinceLastFrame == hop)
+            {
+                m_fft->ProcessFFT(Span<const float>(tier.history.data() + tier.writePos, windowSize), tier.result);
+                tier.sinceLastFrame = 0;
+                updated = true;
+            }
+        }
+
+        if (t + 1 == m_tiers.size())
+            break;
+
+        // Half-band filter and drop every other sample for the next tier
+        const size_t history = HalfBandTaps - 1;
+        tier.filterInput.resize(history + count);
+        std::copy(samples, samples + count, tier.filterInput.begin() + history);
+
+        tier.decimated.clear();
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (tier.skipNext)
+            {
+                tier.skipNext = false;
+                continue;
+            }
+            tier.skipNext = true;
+
+            const float* window = &tier.filterInput[i];
+            float sum = 0.0f;
+            for (size_t k = 0; k < filter.offsets.size(); ++k)
+            {
+                sum += window[filter.offsets[k]] * filter.coefficients[k];
+            }
+            tier.decimated.push_back(sum);
+        }
+
+        std::copy(tier.filterInput.end() - history, tier.filterInput.end(), tier.filterInput.begin());
+        tier.filterInput.resize(history);
+
+        samples = tier.decimated.data();
+        count = tier.decimated.size();
+    }
+
+    if (updated)
+    {
+        UpdateBands();
+    }
+    return updated;
+}
+
+void MultiResolutionSpectrum::UpdateBands()
+{
+    // Hann window sum is about fftSize / 2; a sine of amplitude A peaks at A * sum / 2
+    const float scale = 4.0f / (m_fftSize - 1);
+    float maxMagnitude = 0.0f;
+
+    for (size_t band = 0; band < m_kernels.size(); ++band)
+    {
+        const BandKernel& kernel = m_kernels[band];
+        const float* bins = m_tiers[kernel.tier]->result.magnitudes.data() + kernel.firstBin;
+
+        float sum = 0.0f;
+        for (int i = 0; i < kernel.binCount; ++i)
+        {
+            sum += bins[i];
+            maxMagnitude = std::max(maxMagnitude, bins[i]);
+        }
+        m_bandMagnitudes[band] = sum / kernel.binCount * scale;
+    }
+
+    m_maxMagnitude = maxMagnitude * scale;
+}
+
+double MultiResolutionSpectrum::GetWindowSeconds(int tier) const
+{
+    return static_cast<double>(m_fftSize) * (1 << tier) / m_sampleRate;
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include "BandWeightMatrix.h"
+#include "FFTProcessor.h"
+#include "../Utils/AlignedAllocator.h"
+#include "../Utils/Span.h"
+#include <memory>
+#include <vector>
+
+// Multi-resolution band analysis: long windows for low bands, short ones for high bands,
+// at roughly constant cost per octave. Tier t sees the input decimated by 2^t (cascaded
+// half-band filters) through the same 'fftSize' FFT, so its window is 2^t times longer
+// in time and its bins 2^t times narrower. Each band reads the shallowest tier that gives
+// it MinBinsPerBand bins (below that tier's alias-free limit); its magnitude is the mean
+// of those bins, scaled so a sine of amplitude A reads about A. Tier t takes a new
+// spectrum every fftSize / 4 of its own samples.
+// Not thread safe: push and read from the same thread.
+class MultiResolutionSpectrum
+{
+public:
+    explicit MultiResolutionSpectrum(int fftSize = 1024, int maxTiers = 8);
+    ~MultiResolutionSpectrum();
+
+    // Assigns every band a tier; tiers no band needs are not computed. Clears history.
+    bool Configure(int sampleRate, const std::vector<BandEdges>& bands);
+    void Reset();
+
+    // Returns true when at least one tier produced a new spectrum
+    bool Push(const float* samples, size_t count);
+
+    Span<const float> GetBandMagnitudes() const { return Span<const float>(m_bandMagnitudes); }
+    float GetMaxMagnitude() const { return m_maxMagnitude; } // Loudest bin any band reads
+
+    int GetFFTSize() const { return m_fftSize; }
+    int GetTierCount() const { return static_cast<int>(m_tiers.size()); }
+    int GetBandTier(size_t band) const { return m_kernels[band].tier; }
+    double GetWindowSeconds(int tier) const;
+
+    static constexpr int MinBinsPerBand = 3;
+    static constexpr float AliasFreeLimit = 0.38f; // Of a tier's sample rate, after the half-band filters
+
+private:
+    struct Tier;
+
+    // Sparse kernel: a run of equally weighted bins in one tier
+    struct BandKernel
+    {
+        int tier;
+        int firstBin;
+        int binCount;
+    };
+
+    void UpdateBands();
+
+    int m_fftSize;
+    int m_maxTiers;
+    int m_sampleRate;
+    std::unique_ptr<FFTProcessor> m_fft; // Shared by the tiers: same size, used one at a time
+    std::vector<std::unique_ptr<Tier>> m_tiers;
+    std::vector<BandKernel> m_kernels;
+    std::vector<float> m_bandMagnitudes;
+    float m_maxMagnitude;
+};
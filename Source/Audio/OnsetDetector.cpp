@@ -0,0 +1,90 @@
+#include "OnsetDetector.h"
+#include <algorithm>
+#include <cmath>
+
+OnsetDetector::OnsetDetector()
+    : m_frameRate(0.0), m_hasPrevious(false), m_fluxPos(0), m_fluxCount(0), m_fluxSum(0.0),
+      m_flux(0.0f), m_threshold(0.0f), m_lastFlux(0.0f), m_lastThreshold(0.0f), m_lastLastFlux(0.0f), m_lastTime(0.0),
+      m_isOnset(false), m_onsetTime(0.0), m_lastOnsetTime(0.0)
+{
+    Reset(48000.0 / 1024.0);
+}
+
+void OnsetDetector::Reset(double frameRate)
+{
+    m_frameRate = frameRate > 0.0 ? frameRate : m_frameRate;
+    m_previous.clear();
+    m_hasPrevious = false;
+
+    m_fluxHistory.assign(std::max(static_cast<size_t>(ThresholdSeconds * m_frameRate + 0.5), static_cast<size_t>(1)), 0.0f);
+    m_fluxPos = 0;
+    m_fluxCount = 0;
+    m_fluxSum = 0.0;
+
+    m_flux = 0.0f;
+    m_threshold = 0.0f;
+    m_lastFlux = 0.0f;
+    m_lastThreshold = 0.0f;
+    m_lastLastFlux = 0.0f;
+    m_lastTime = 0.0;
+
+    m_isOnset = false;
+    m_onsetTime = 0.0;
+    m_lastOnsetTime = -HUGE_VAL; // Frame times start negative (the first windows reach back before zero)
+}
+
+float OnsetDetector::Process(Span<const float> magnitudes, double time)
+{
+    const size_t binCount = magnitudes.size();
+    if (binCount < 2)
+        return 0.0f;
+
+    // Hann window sum is about fftSize / 2; a sine of amplitude A peaks at A * sum / 2
+    const float scale = Compression * 4.0f / (2.0f * (binCount - 1));
+
+    if (m_previous.size() != binCount)
+    {
+        m_previous.assign(binCount, 0.0f);
+        m_hasPrevious = false;
+    }
+
+    // Compress in place over the previous spectrum, summing the rises as we go
+    float rise = 0.0f;
+    float* previous = m_previous.data();
+    for (size_t bin = 0; bin < binCount; ++bin)
+    {
+        float level = log1pf(magnitudes[bin] * scale);
+        rise += std::max(level - previous[bin], 0.0f);
+        previous[bin] = level;
+    }
+
+    const float flux = m_hasPrevious ? rise / binCount : 0.0f;
+    m_hasPrevious = true;
+
+    // Threshold from the frames before this one, so an onset does not raise its own bar
+    const float mean = m_fluxCount > 0 ? static_cast<float>(m_fluxSum / m_fluxCount) : flux;
+    const float threshold = mean * ThresholdRatio + ThresholdOffset;
+
+    m_fluxSum += flux - m_fluxHistory[m_fluxPos];
+    m_fluxHistory[m_fluxPos] = flux;
+    m_fluxPos = (m_fluxPos + 1) % m_fluxHistory.size();
+    m_fluxCount = std::min(m_fluxCount + 1, m_fluxHistory.size());
+
+    // The previous frame is an onset if it rose above both neighbours and its threshold
+    m_isOnset = m_lastFlux > m_lastLastFlux && m_lastFlux >= flux && m_lastFlux > m_lastThreshold &&
+        m_lastTime - m_lastOnsetTime >= MinOnsetInterval;
+    if (m_isOnset)
+    {
+        m_onsetTime = m_lastTime;
+        m_lastOnsetTime = m_lastTime;
+    }
+
+    m_lastLastFlux = m_lastFlux;
+    m_lastFlux = flux;
+    m_lastThreshold = threshold;
+    m_lastTime = time;
+    m_flux = flux;
+    m_threshold = threshold;
+
+    return std::max(flux - mean, 0.0f);
+}
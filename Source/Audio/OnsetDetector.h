@@ -0,0 +1,62 @@
+#pragma once
+#include "../Utils/AlignedAllocator.h"
+#include "../Utils/Span.h"
+#include <vector>
+
+// Streaming onset detection by spectral flux. Each spectrum is log compressed
+// (log(1 + Compression * |X|), with |X| scaled so a full-scale sine reads about 1), and
+// the flux is the mean positive change per bin since the previous spectrum. A frame is
+// an onset when its flux is a local maximum above an adaptive threshold: the mean flux
+// of the last ThresholdSeconds times ThresholdRatio, plus ThresholdOffset. Peaks are
+// confirmed one frame late, since a maximum needs the next frame.
+// Feed consecutive overlapping spectra of one size (e.g. every STFTProcessor frame).
+// Not thread safe.
+class OnsetDetector
+{
+public:
+    OnsetDetector();
+
+    // Clears all history; 'frameRate' is the number of spectra per second
+    void Reset(double frameRate);
+
+    // Processes the spectrum of the frame centred at 'time' seconds and returns its
+    // novelty: the flux above the local mean, the onset strength a beat tracker wants
+    float Process(Span<const float> magnitudes, double time);
+
+    // Whether this Process() confirmed an onset, and when (the previous frame's time)
+    bool IsOnset() const { return m_isOnset; }
+    double GetOnsetTime() const { return m_onsetTime; }
+
+    float GetFlux() const { return m_flux; }
+    float GetThreshold() const { return m_threshold; }
+    double GetFrameRate() const { return m_frameRate; }
+
+    static constexpr float Compression = 100.0f;
+    static constexpr float ThresholdSeconds = 0.5f;
+    static constexpr float ThresholdRatio = 1.5f;
+    static constexpr float ThresholdOffset = 0.002f;
+    static constexpr float MinOnsetInterval = 0.05f; // Seconds between onsets
+
+private:
+    double m_frameRate;
+    AlignedVector<float> m_previous; // Last log-compressed spectrum
+    bool m_hasPrevious;
+
+    // Recent flux values for the threshold (ring) and their running sum
+    std::vector<float> m_fluxHistory;
+    size_t m_fluxPos;
+    size_t m_fluxCount;
+    double m_fluxSum;
+
+    // Peak picking: the previous two frames' flux and threshold
+    float m_flux;
+    float m_threshold;
+    float m_lastFlux;
+    float m_lastThreshold;
+    float m_lastLastFlux;
+    double m_lastTime;
+
+    bool m_isOnset;
+    double m_onsetTime;
+    double m_lastOnsetTime;
+};
@@ -0,0 +1,319 @@
+#include "PCMConvertKernels.h"
+#include <atomic>
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace
+{
+    SIMDLevel DetectSupportedLevel()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] >= 7)
+        {
+            __cpuid(info, 1);
+            bool osSavesYmm = (info[2] & (1 << 27)) != 0;
+            bool hasAVX = (info[2] & (1 << 28)) != 0;
+
+            __cpuidex(info, 7, 0);
+            bool hasAVX2 = (info[1] & (1 << 5)) != 0;
+
+            if (osSavesYmm && hasAVX && hasAVX2 && (_xgetbv(0) & 6) == 6)
+                return SIMDLevel::AVX2;
+        }
+        return SIMDLevel::SSE2;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? SIMDLevel::AVX2 : SIMDLevel::SSE2;
+#endif
+    }
+
+    std::atomic<SIMDLevel>& ActiveLevel()
+    {
+        static std::atomic<SIMDLevel> level(PCMConvert::GetSupportedLevel());
+        return level;
+    }
+
+    template <SampleFormat Format>
+    void ConvertScalar(const uint8_t* source, size_t frameCount, float* destination, int numChannels)
+    {
+        ConvertFramesScalar<Format>(source, 0, frameCount, destination, numChannels);
+    }
+
+    // Decodes 4 consecutive samples starting at 'index'
+    template <SampleFormat Format>
+    inline __m128 Load4(const uint8_t* source, size_t index)
+    {
+        if constexpr (Format == SampleFormat::UInt8)
+        {
+            int32_t bytes;
+            memcpy(&bytes, source + index, 4);
+            __m128i zero = _mm_setzero_si128();
+            __m128i widened = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+            __m128i centered = _mm_sub_epi32(widened, _mm_set1_epi32(128));
+            return _mm_mul_ps(_mm_cvtepi32_ps(centered), _mm_set1_ps(1.0f / 128.0f));
+        }
+        else if constexpr (Format == SampleFormat::Int16)
+        {
+            __m128i raw = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + index * 2));
+            __m128i widened = _mm_srai_epi32(_mm_unpacklo_epi16(raw, raw), 16);
+            return _mm_mul_ps(_mm_cvtepi32_ps(widened), _mm_set1_ps(1.0f / 32768.0f));
+        }
+        else if constexpr (Format == SampleFormat::Int24)
+        {
+            // Each 32-bit load carries one byte of the next sample, shifted out below
+            int32_t words[4];
+            const uint8_t* p = source + index * 3;
+            memcpy(&words[0], p, 4);
+            memcpy(&words[1], p + 3, 4);
+            memcpy(&words[2], p + 6, 4);
+            memcpy(&words[3], p + 9, 4);
+            __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words));
+            __m128i extended = _mm_srai_epi32(_mm_slli_epi32(raw, 8), 8);
+            return _mm_mul_ps(_mm_cvtepi32_ps(extended), _mm_set1_ps(1.0f / 8388608.0f));
+        }
+        else if constexpr (Format == SampleFormat::Int32)
+        {
+            __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index * 4));
+            return _mm_mul_ps(_mm_cvtepi32_ps(raw), _mm_set1_ps(1.0f / 2147483648.0f));
+        }
+        else if constexpr (Format == SampleFormat::Float32)
+        {
+            return _mm_loadu_ps(reinterpret_cast<const float*>(source + index * 4));
+        }
+        else
+        {
+            const double* values = reinterpret_cast<const double*>(source + index * 8);
+            return _mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(values)), _mm_cvtpd_ps(_mm_loadu_pd(values + 2)));
+        }
+    }
+
+    // Channels == 0 selects the generic N-channel kernel
+    template <SampleFormat Format, int Channels>
+    void ConvertSSE2(const uint8_t* source, size_t frameCount, float* destination, int numChannels)
+    {
+        // 24-bit loads read past the last sample, keep the final frames for the scalar tail
+        const size_t guardFrames = (Format == SampleFormat::Int24) ? 2 : 0;
+        const size_t simdEnd = frameCount > guardFrames ? frameCount - guardFrames : 0;
+
+        size_t i = 0;
+        for (; i + 4 <= simdEnd; i += 4)
+        {
+            __m128 sample;
+
+            if constexpr (Channels == 1)
+            {
+                sample = Load4<Format>(source, i);
+            }
+            else if constexpr (Channels == 2)
+            {
+                __m128 a = Load4<Format>(source, i * 2);
+                __m128 b = Load4<Format>(source, i * 2 + 4);
+                __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                sample = _mm_mul_ps(_mm_add_ps(left, right), _mm_set1_ps(0.5f));
+            }
+            else
+            {
+                sample = _mm_setzero_ps();
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    __m128 channel = _mm_set_ps(
+                        DecodeSample<Format>(source, (i + 3) * numChannels + ch),
+                        DecodeSample<Format>(source, (i + 2) * numChannels + ch),
+                        DecodeSample<Format>(source, (i + 1) * numChannels + ch),
+                        DecodeSample<Format>(source, i * numChannels + ch));
+                    sample = _mm_add_ps(sample, channel);
+                }
+                sample = _mm_div_ps(sample, _mm_set1_ps(static_cast<float>(numChannels)));
+            }
+
+            _mm_storeu_ps(destination + i, sample);
+        }
+
+        ConvertFramesScalar<Format>(source, i, frameCount, destination, numChannels);
+    }
+
+    template <SampleFormat Format>
+    PCMConvertFunc SelectSSE2(int numChannels)
+    {
+        if (numChannels == 1) return ConvertSSE2<Format, 1>;
+        if (numChannels == 2) return ConvertSSE2<Format, 2>;
+        return ConvertSSE2<Format, 0>;
+    }
+
+    template <SampleFormat Format>
+    void DeinterleaveScalar(const uint8_t* source, size_t frameCount, float* const* channels, size_t channelOffset, int numChannels)
+    {
+        DeinterleaveFramesScalar<Format>(source, 0, frameCount, channels, channelOffset, numChannels);
+    }
+
+    // Mono and stereo are vectorized; wider layouts use the scalar loop per channel
+    template <SampleFormat Format>
+    void DeinterleaveSSE2(const uint8_t* source, size_t frameCount, float* const* channels, size_t channelOffset, int numChannels)
+    {
+        if (numChannels > 2)
+        {
+            DeinterleaveFramesScalar<Format>(source, 0, frameCount, channels, channelOffset, numChannels);
+            return;
+        }
+
+        const size_t guardFrames = (Format == SampleFormat::Int24) ? 2 : 0;
+        const size_t simdEnd = frameCount > guardFrames ? frameCount - guardFrames : 0;
+        float* left = channels[0] + channelOffset;
+
+        size_t i = 0;
+        if (numChannels == 1)
+        {
+            for (; i + 4 <= simdEnd; i += 4)
+            {
+                _mm_storeu_ps(left + i, Load4<Format>(source, i));
+            }
+        }
+        else
+        {
+            float* right = channels[1] + channelOffset;
+            for (; i + 4 <= simdEnd; i += 4)
+            {
+                __m128 a = Load4<Format>(source, i * 2);
+                __m128 b = Load4<Format>(source, i * 2 + 4);
+                _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+            }
+        }
+
+        DeinterleaveFramesScalar<Format>(source, i, frameCount, channels, channelOffset, numChannels);
+    }
+}
+
+namespace PCMConvert
+{
+    PCMConvertFunc SelectKernel(SampleFormat format, int numChannels)
+    {
+        if (format == SampleFormat::Float32 && numChannels == 1)
+        {
+            return CopyFloat32Mono;
+        }
+
+        switch (GetActiveLevel())
+        {
+        case SIMDLevel::AVX2:
+            return SelectKernelAVX2(format, numChannels);
+
+        case SIMDLevel::SSE2:
+            switch (format)
+            {
+            case SampleFormat::UInt8: return SelectSSE2<SampleFormat::UInt8>(numChannels);
+            case SampleFormat::Int16: return SelectSSE2<SampleFormat::Int16>(numChannels);
+            case SampleFormat::Int24: return SelectSSE2<SampleFormat::Int24>(numChannels);
+            case SampleFormat::Int32: return SelectSSE2<SampleFormat::Int32>(numChannels);
+            case SampleFormat::Float32: return SelectSSE2<SampleFormat::Float32>(numChannels);
+            case SampleFormat::Float64: return SelectSSE2<SampleFormat::Float64>(numChannels);
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        switch (format)
+        {
+        case SampleFormat::UInt8: return ConvertScalar<SampleFormat::UInt8>;
+        case SampleFormat::Int16: return ConvertScalar<SampleFormat::Int16>;
+        case SampleFormat::Int24: return ConvertScalar<SampleFormat::Int24>;
+        case SampleFormat::Int32: return ConvertScalar<SampleFormat::Int32>;
+        case SampleFormat::Float32: return ConvertScalar<SampleFormat::Float32>;
+        case SampleFormat::Float64: return ConvertScalar<SampleFormat::Float64>;
+        }
+        return nullptr;
+    }
+
+    PCMDeinterleaveFunc SelectDeinterleaveKernel(SampleFormat format, int numChannels)
+    {
+        SIMDLevel level = GetActiveLevel();
+        if (level == SIMDLevel::AVX2)
+        {
+            return SelectDeinterleaveKernelAVX2(format, numChannels);
+        }
+
+        bool useSSE2 = level == SIMDLevel::SSE2;
+        switch (format)
+        {
+        case SampleFormat::UInt8: return useSSE2 ? DeinterleaveSSE2<SampleFormat::UInt8> : DeinterleaveScalar<SampleFormat::UInt8>;
+        case SampleFormat::Int16: return useSSE2 ? DeinterleaveSSE2<SampleFormat::Int16> : DeinterleaveScalar<SampleFormat::Int16>;
+        case SampleFormat::Int24: return useSSE2 ? DeinterleaveSSE2<SampleFormat::Int24> : DeinterleaveScalar<SampleFormat::Int24>;
+        case SampleFormat::Int32: return useSSE2 ? DeinterleaveSSE2<SampleFormat::Int32> : DeinterleaveScalar<SampleFormat::Int32>;
+        case SampleFormat::Float32: return useSSE2 ? DeinterleaveSSE2<SampleFormat::Float32> : DeinterleaveScalar<SampleFormat::Float32>;
+        case SampleFormat::Float64: return useSSE2 ? DeinterleaveSSE2<SampleFormat::Float64> : DeinterleaveScalar<SampleFormat::Float64>;
+        }
+        return nullptr;
+    }
+
+    bool GetSampleFormat(uint16_t audioFormat, int bitsPerSample, SampleFormat& format)
+    {
+        if (audioFormat == 1) // PCM
+        {
+            switch (bitsPerSample)
+            {
+            case 8: format = SampleFormat::UInt8; return true;
+            case 16: format = SampleFormat::Int16; return true;
+            case 24: format = SampleFormat::Int24; return true;
+            case 32: format = SampleFormat::Int32; return true;
+            }
+        }
+        else if (audioFormat == 3) // IEEE float
+        {
+            switch (bitsPerSample)
+            {
+            case 32: format = SampleFormat::Float32; return true;
+            case 64: format = SampleFormat::Float64; return true;
+            }
+        }
+        return false;
+    }
+
+    int GetBytesPerSample(SampleFormat format)
+    {
+        switch (format)
+        {
+        case SampleFormat::UInt8: return 1;
+        case SampleFormat::Int16: return 2;
+        case SampleFormat::Int24: return 3;
+        case SampleFormat::Float64: return 8;
+        default: return 4;
+        }
+    }
+
+    SIMDLevel GetSupportedLevel()
+    {
+        static const SIMDLevel supported = DetectSupportedLevel();
+        return supported;
+    }
+
+    SIMDLevel GetActiveLevel()
+    {
+        return ActiveLevel().load(std::memory_order_relaxed);
+    }
+
+    void SetActiveLevel(SIMDLevel level)
+    {
+        if (static_cast<int>(level) > static_cast<int>(GetSupportedLevel()))
+            level = GetSupportedLevel();
+
+        ActiveLevel().store(level, std::memory_order_relaxed);
+    }
+
+    const char* GetLevelName(SIMDLevel level)
+    {
+        switch (level)
+        {
+        case SIMDLevel::AVX2: return "AVX2";
+        case SIMDLevel::SSE2: return "SSE2";
+        default: return "Scalar";
+        }
+    }
+}
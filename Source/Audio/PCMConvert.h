@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+enum class SampleFormat
+{
+    UInt8,
+    Int16,
+    Int24,
+    Int32,
+    Float32,
+    Float64
+};
+
+enum class SIMDLevel
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// Converts 'frameCount' interleaved frames to mono float, averaging channels.
+// Integer formats land in [-1, 1); float input keeps its headroom and is not clamped.
+typedef void (*PCMConvertFunc)(const uint8_t* source, size_t frameCount, float* destination, int numChannels);
+
+// Splits 'frameCount' interleaved frames into planar float channels, writing each
+// channel starting at channels[ch][channelOffset]
+typedef void (*PCMDeinterleaveFunc)(const uint8_t* source, size_t frameCount, float* const* channels, size_t channelOffset, int numChannels);
+
+namespace PCMConvert
+{
+    // Picks the kernel for one file; call once per file, not per sample
+    PCMConvertFunc SelectKernel(SampleFormat format, int numChannels);
+    PCMDeinterleaveFunc SelectDeinterleaveKernel(SampleFormat format, int numChannels);
+    bool GetSampleFormat(uint16_t audioFormat, int bitsPerSample, SampleFormat& format);
+    int GetBytesPerSample(SampleFormat format);
+
+    SIMDLevel GetSupportedLevel();
+    SIMDLevel GetActiveLevel();
+    void SetActiveLevel(SIMDLevel level); // Clamped to what the CPU supports
+    const char* GetLevelName(SIMDLevel level);
+
+    // AVX2 kernels live in their own translation unit built with /arch:AVX2
+    PCMConvertFunc SelectKernelAVX2(SampleFormat format, int numChannels);
+    PCMDeinterleaveFunc SelectDeinterleaveKernelAVX2(SampleFormat format, int numChannels);
+}
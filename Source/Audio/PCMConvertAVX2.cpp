@@ -0,0 +1,202 @@
+#include "PCMConvertKernels.h"
+#include <immintrin.h>
+
+// Built with /arch:AVX2; only reached when PCMConvert detected AVX2 support at runtime
+
+namespace
+{
+    const int MaxTileChannels = 32;
+
+    // Decodes 8 consecutive samples starting at 'index'
+    template <SampleFormat Format>
+    inline __m256 Load8(const uint8_t* source, size_t index)
+    {
+        if constexpr (Format == SampleFormat::UInt8)
+        {
+            __m128i raw = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source + index));
+            __m256i centered = _mm256_sub_epi32(_mm256_cvtepu8_epi32(raw), _mm256_set1_epi32(128));
+            return _mm256_mul_ps(_mm256_cvtepi32_ps(centered), _mm256_set1_ps(1.0f / 128.0f));
+        }
+        else if constexpr (Format == SampleFormat::Int16)
+        {
+            __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + index * 2));
+            return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(raw)), _mm256_set1_ps(1.0f / 32768.0f));
+        }
+        else if constexpr (Format == SampleFormat::Int24)
+        {
+            // Two overlapping 16-byte loads cover 8 packed samples (reads 4 bytes past them).
+            // The shuffle moves each sample into the top 3 bytes of a lane, the shift sign extends.
+            const uint8_t* p = source + index * 3;
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 12));
+            __m256i raw = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+
+            const __m256i shuffle = _mm256_setr_epi8(
+                -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11,
+                -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            __m256i extended = _mm256_srai_epi32(_mm256_shuffle_epi8(raw, shuffle), 8);
+            return _mm256_mul_ps(_mm256_cvtepi32_ps(extended), _mm256_set1_ps(1.0f / 8388608.0f));
+        }
+        else if constexpr (Format == SampleFormat::Int32)
+        {
+            __m256i raw = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + index * 4));
+            return _mm256_mul_ps(_mm256_cvtepi32_ps(raw), _mm256_set1_ps(1.0f / 2147483648.0f));
+        }
+        else if constexpr (Format == SampleFormat::Float32)
+        {
+            return _mm256_loadu_ps(reinterpret_cast<const float*>(source + index * 4));
+        }
+        else
+        {
+            const double* values = reinterpret_cast<const double*>(source + index * 8);
+            __m128 low = _mm256_cvtpd_ps(_mm256_loadu_pd(values));
+            __m128 high = _mm256_cvtpd_ps(_mm256_loadu_pd(values + 4));
+            return _mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1);
+        }
+    }
+
+    // Channels == 0 selects the generic N-channel kernel
+    template <SampleFormat Format, int Channels>
+    void ConvertAVX2(const uint8_t* source, size_t frameCount, float* destination, int numChannels)
+    {
+        const size_t guardFrames = (Format == SampleFormat::Int24) ? 2 : 0;
+        const size_t simdEnd = frameCount > guardFrames ? frameCount - guardFrames : 0;
+
+        size_t i = 0;
+        for (; i + 8 <= simdEnd; i += 8)
+        {
+            __m256 sample;
+
+            if constexpr (Channels == 1)
+            {
+                sample = Load8<Format>(source, i);
+            }
+            else if constexpr (Channels == 2)
+            {
+                // Split L/R within each 128-bit lane, then restore frame order across lanes
+                __m256 a = Load8<Format>(source, i * 2);
+                __m256 b = Load8<Format>(source, i * 2 + 8);
+                __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                __m256 sum = _mm256_mul_ps(_mm256_add_ps(left, right), _mm256_set1_ps(0.5f));
+                sample = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0)));
+            }
+            else if (numChannels <= MaxTileChannels)
+            {
+                // Decode the 8 frames as contiguous samples, then gather each channel back out
+                alignas(32) float tile[8 * MaxTileChannels];
+                for (int k = 0; k < numChannels; ++k)
+                {
+                    _mm256_store_ps(tile + k * 8, Load8<Format>(source, i * numChannels + k * 8));
+                }
+
+                const __m256i stride = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(numChannels));
+                sample = _mm256_setzero_ps();
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    sample = _mm256_add_ps(sample, _mm256_i32gather_ps(tile + ch, stride, 4));
+                }
+                sample = _mm256_div_ps(sample, _mm256_set1_ps(static_cast<float>(numChannels)));
+            }
+            else
+            {
+                sample = _mm256_setzero_ps();
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    float lanes[8];
+                    for (int lane = 0; lane < 8; ++lane)
+                    {
+                        lanes[lane] = DecodeSample<Format>(source, (i + lane) * numChannels + ch);
+                    }
+                    sample = _mm256_add_ps(sample, _mm256_loadu_ps(lanes));
+                }
+                sample = _mm256_div_ps(sample, _mm256_set1_ps(static_cast<float>(numChannels)));
+            }
+
+            _mm256_storeu_ps(destination + i, sample);
+        }
+
+        // The scalar tail is reached by a tail call, which compilers do not guard with a
+        // vzeroupper; dirty upper halves would slow every SSE instruction after we return
+        _mm256_zeroupper();
+        ConvertFramesScalar<Format>(source, i, frameCount, destination, numChannels);
+    }
+
+    template <SampleFormat Format>
+    void DeinterleaveAVX2(const uint8_t* source, size_t frameCount, float* const* channels, size_t channelOffset, int numChannels)
+    {
+        if (numChannels > 2)
+        {
+            DeinterleaveFramesScalar<Format>(source, 0, frameCount, channels, channelOffset, numChannels);
+            return;
+        }
+
+        const size_t guardFrames = (Format == SampleFormat::Int24) ? 2 : 0;
+        const size_t simdEnd = frameCount > guardFrames ? frameCount - guardFrames : 0;
+        float* left = channels[0] + channelOffset;
+
+        size_t i = 0;
+        if (numChannels == 1)
+        {
+            for (; i + 8 <= simdEnd; i += 8)
+            {
+                _mm256_storeu_ps(left + i, Load8<Format>(source, i));
+            }
+        }
+        else
+        {
+            float* right = channels[1] + channelOffset;
+            for (; i + 8 <= simdEnd; i += 8)
+            {
+                __m256 a = Load8<Format>(source, i * 2);
+                __m256 b = Load8<Format>(source, i * 2 + 8);
+                __m256 l = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+                __m256 r = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+                _mm256_storeu_ps(left + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0))));
+                _mm256_storeu_ps(right + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0))));
+            }
+        }
+
+        _mm256_zeroupper();
+        DeinterleaveFramesScalar<Format>(source, i, frameCount, channels, channelOffset, numChannels);
+    }
+
+    template <SampleFormat Format>
+    PCMConvertFunc SelectAVX2(int numChannels)
+    {
+        if (numChannels == 1) return ConvertAVX2<Format, 1>;
+        if (numChannels == 2) return ConvertAVX2<Format, 2>;
+        return ConvertAVX2<Format, 0>;
+    }
+}
+
+namespace PCMConvert
+{
+    PCMConvertFunc SelectKernelAVX2(SampleFormat format, int numChannels)
+    {
+        switch (format)
+        {
+        case SampleFormat::UInt8: return SelectAVX2<SampleFormat::UInt8>(numChannels);
+        case SampleFormat::Int16: return SelectAVX2<SampleFormat::Int16>(numChannels);
+        case SampleFormat::Int24: return SelectAVX2<SampleFormat::Int24>(numChannels);
+        case SampleFormat::Int32: return SelectAVX2<SampleFormat::Int32>(numChannels);
+        case SampleFormat::Float32: return SelectAVX2<SampleFormat::Float32>(numChannels);
+        case SampleFormat::Float64: return SelectAVX2<SampleFormat::Float64>(numChannels);
+        }
+        return nullptr;
+    }
+
+    PCMDeinterleaveFunc SelectDeinterleaveKernelAVX2(SampleFormat format, int)
+    {
+        switch (format)
+        {
+        case SampleFormat::UInt8: return DeinterleaveAVX2<SampleFormat::UInt8>;
+        case SampleFormat::Int16: return DeinterleaveAVX2<SampleFormat::Int16>;
+        case SampleFormat::Int24: return DeinterleaveAVX2<SampleFormat::Int24>;
+        case SampleFormat::Int32: return DeinterleaveAVX2<SampleFormat::Int32>;
+        case SampleFormat::Float32: return DeinterleaveAVX2<SampleFormat::Float32>;
+        case SampleFormat::Float64: return DeinterleaveAVX2<SampleFormat::Float64>;
+        }
+        return nullptr;
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include "PCMConvert.h"
+#include <cstring>
+
+// Scalar sample decoding shared by the conversion kernels (also used for SIMD loop tails).
+// Only include this from the kernel translation units: everything here has internal
+// linkage so the copy compiled with /arch:AVX2 can never be picked by the linker for
+// the baseline SSE2 path.
+namespace
+{
+    template <SampleFormat Format>
+    inline float DecodeSample(const uint8_t* source, size_t index)
+    {
+        if constexpr (Format == SampleFormat::UInt8)
+        {
+            return static_cast<float>(static_cast<int>(source[index]) - 128) / 128.0f;
+        }
+        else if constexpr (Format == SampleFormat::Int16)
+        {
+            int16_t value;
+            memcpy(&value, source + index * 2, 2);
+            return static_cast<float>(value) / 32768.0f;
+        }
+        else if constexpr (Format == SampleFormat::Int24)
+        {
+            // Place the 3 bytes in the top of a 32-bit word and shift back to sign extend
+            const uint8_t* p = source + index * 3;
+            uint32_t bits = (static_cast<uint32_t>(p[2]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[0]) << 8);
+            return static_cast<float>(static_cast<int32_t>(bits) >> 8) / 8388608.0f;
+        }
+        else if constexpr (Format == SampleFormat::Int32)
+        {
+            int32_t value;
+            memcpy(&value, source + index * 4, 4);
+            return static_cast<float>(value) / 2147483648.0f;
+        }
+        else if constexpr (Format == SampleFormat::Float32)
+        {
+            float value;
+            memcpy(&value, source + index * 4, 4);
+            return value;
+        }
+        else
+        {
+            double value;
+            memcpy(&value, source + index * 8, 8);
+            return static_cast<float>(value);
+        }
+    }
+
+    template <SampleFormat Format>
+    void ConvertFramesScalar(const uint8_t* source, size_t firstFrame, size_t lastFrame, float* destination, int numChannels)
+    {
+        for (size_t i = firstFrame; i < lastFrame; ++i)
+        {
+            float sample = 0.0f;
+
+            if (numChannels == 1)
+            {
+                sample = DecodeSample<Format>(source, i);
+            }
+            else if (numChannels == 2) // Stereo - convert to mono by averaging
+            {
+                sample = (DecodeSample<Format>(source, i * 2) + DecodeSample<Format>(source, i * 2 + 1)) * 0.5f;
+            }
+            else
+            {
+                // Average channels
+                for (int ch = 0; ch < numChannels; ++ch)
+                {
+                    sample += DecodeSample<Format>(source, i * numChannels + ch);
+                }
+                sample /= numChannels;
+            }
+
+            destination[i] = sample;
+        }
+    }
+
+    template <SampleFormat Format>
+    void DeinterleaveFramesScalar(const uint8_t* source, size_t firstFrame, size_t lastFrame, float* const* channels, size_t channelOffset, int numChannels)
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* destination = channels[ch] + channelOffset;
+            for (size_t i = firstFrame; i < lastFrame; ++i)
+            {
+                destination[i] = DecodeSample<Format>(source, i * numChannels + ch);
+            }
+        }
+    }
+
+    // Mono float32 needs no conversion at all
+    inline void CopyFloat32Mono(const uint8_t* source, size_t frameCount, float* destination, int)
+    {
+        memcpy(destination, source, frameCount * sizeof(float));
+    }
+}
@@ -0,0 +1,365 @@
+#include "RealFFTKernels.h"
+#include "PCMConvert.h"
+#include <cmath>
+#include <emmintrin.h>
+
+// Stockham autosort, decimation in frequency. A pass over sub-transforms of 'length'
+// points with 'stride' of them interleaved reads x[q + stride * (p + k * length / 4)]
+// and writes y[q + stride * (4p + k)], so the output lands in natural order without a
+// bit-reversal pass. The next pass has a quarter of the length and four times the stride.
+
+namespace
+{
+    const double Pi = 3.14159265358979323846;
+
+    // Complex multiply of split vectors: (ar + i ai) * (br + i bi)
+    inline void MultiplySSE2(__m128 ar, __m128 ai, __m128 br, __m128 bi, __m128& outR, __m128& outI)
+    {
+        outR = _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi));
+        outI = _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br));
+    }
+
+    // One radix-4 butterfly on 4 lanes. a..d are the four inputs, w1..w3 the twiddles.
+    inline void ButterflySSE2(
+        __m128 ar, __m128 ai, __m128 br, __m128 bi, __m128 cr, __m128 ci, __m128 dr, __m128 di,
+        __m128 w1r, __m128 w1i, __m128 w2r, __m128 w2i, __m128 w3r, __m128 w3i,
+        __m128& y0r, __m128& y0i, __m128& y1r, __m128& y1i, __m128& y2r, __m128& y2i, __m128& y3r, __m128& y3i)
+    {
+        __m128 apcR = _mm_add_ps(ar, cr), apcI = _mm_add_ps(ai, ci);
+        __m128 amcR = _mm_sub_ps(ar, cr), amcI = _mm_sub_ps(ai, ci);
+        __m128 bpdR = _mm_add_ps(br, dr), bpdI = _mm_add_ps(bi, di);
+        __m128 bmdR = _mm_sub_ps(br, dr), bmdI = _mm_sub_ps(bi, di);
+
+        y0r = _mm_add_ps(apcR, bpdR);
+        y0i = _mm_add_ps(apcI, bpdI);
+
+        // (a - c) - j(b - d) and (a - c) + j(b - d)
+        MultiplySSE2(_mm_add_ps(amcR, bmdI), _mm_sub_ps(amcI, bmdR), w1r, w1i, y1r, y1i);
+        MultiplySSE2(_mm_sub_ps(apcR, bpdR), _mm_sub_ps(apcI, bpdI), w2r, w2i, y2r, y2i);
+        MultiplySSE2(_mm_sub_ps(amcR, bmdI), _mm_add_ps(amcI, bmdR), w3r, w3i, y3r, y3i);
+    }
+
+    // First pass (stride 1): vectorised across p, then a 4x4 transpose puts the four
+    // outputs of each butterfly next to each other
+    void Radix4FirstPassSSE2(int length, const float* xr, const float* xi, float* yr, float* yi, const float* twiddles)
+    {
+        const int quarter = length / 4;
+        const float* w1r = twiddles;
+        const float* w1i = twiddles + quarter;
+        const float* w2r = twiddles + quarter * 2;
+        const float* w2i = twiddles + quarter * 3;
+        const float* w3r = twiddles + quarter * 4;
+        const float* w3i = twiddles + quarter * 5;
+
+        for (int p = 0; p < quarter; p += 4)
+        {
+            __m128 y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i;
+            ButterflySSE2(
+                _mm_load_ps(xr + p), _mm_load_ps(xi + p),
+                _mm_load_ps(xr + p + quarter), _mm_load_ps(xi + p + quarter),
+                _mm_load_ps(xr + p + quarter * 2), _mm_load_ps(xi + p + quarter * 2),
+                _mm_load_ps(xr + p + quarter * 3), _mm_load_ps(xi + p + quarter * 3),
+                _mm_load_ps(w1r + p), _mm_load_ps(w1i + p), _mm_load_ps(w2r + p), _mm_load_ps(w2i + p),
+                _mm_load_ps(w3r + p), _mm_load_ps(w3i + p),
+                y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i);
+
+            _MM_TRANSPOSE4_PS(y0r, y1r, y2r, y3r);
+            _MM_TRANSPOSE4_PS(y0i, y1i, y2i, y3i);
+
+            float* outR = yr + p * 4;
+            float* outI = yi + p * 4;
+            _mm_store_ps(outR, y0r);
+            _mm_store_ps(outR + 4, y1r);
+            _mm_store_ps(outR + 8, y2r);
+            _mm_store_ps(outR + 12, y3r);
+            _mm_store_ps(outI, y0i);
+            _mm_store_ps(outI + 4, y1i);
+            _mm_store_ps(outI + 8, y2i);
+            _mm_store_ps(outI + 12, y3i);
+        }
+    }
+
+    void Radix2Scalar(int stride, const float* xr, const float* xi, float* yr, float* yi)
+    {
+        for (int q = 0; q < stride; ++q)
+        {
+            float ar = xr[q], ai = xi[q];
+            float br = xr[q + stride], bi = xi[q + stride];
+            yr[q] = ar + br;
+            yi[q] = ai + bi;
+            yr[q + stride] = ar - br;
+            yi[q + stride] = ai - bi;
+        }
+    }
+
+    void Radix2SSE2(int stride, const float* xr, const float* xi, float* yr, float* yi)
+    {
+        for (int q = 0; q < stride; q += 4)
+        {
+            __m128 ar = _mm_load_ps(xr + q), ai = _mm_load_ps(xi + q);
+            __m128 br = _mm_load_ps(xr + q + stride), bi = _mm_load_ps(xi + q + stride);
+            _mm_store_ps(yr + q, _mm_add_ps(ar, br));
+            _mm_store_ps(yi + q, _mm_add_ps(ai, bi));
+            _mm_store_ps(yr + q + stride, _mm_sub_ps(ar, br));
+            _mm_store_ps(yi + q + stride, _mm_sub_ps(ai, bi));
+        }
+    }
+}
+
+namespace RealFFTKernels
+{
+    void Radix4Scalar(int length, int stride, const float* xr, const float* xi, float* yr, float* yi, const float* twiddles)
+    {
+        const int quarter = length / 4;
+
+        for (int p = 0; p < quarter; ++p)
+        {
+            float w1r = twiddles[p], w1i = twiddles[quarter + p];
+            float w2r = twiddles[quarter * 2 + p], w2i = twiddles[quarter * 3 + p];
+            float w3r = twiddles[quarter * 4 + p], w3i = twiddles[quarter * 5 + p];
+
+            for (int q = 0; q < stride; ++q)
+            {
+                size_t in = q + static_cast<size_t>(stride) * p;
+                size_t step = static_cast<size_t>(stride) * quarter;
+                float ar = xr[in], ai = xi[in];
+                float br = xr[in + step], bi = xi[in + step];
+                float cr = xr[in + step * 2], ci = xi[in + step * 2];
+                float dr = xr[in + step * 3], di = xi[in + step * 3];
+
+                float apcR = ar + cr, apcI = ai + ci, amcR = ar - cr, amcI = ai - ci;
+                float bpdR = br + dr, bpdI = bi + di, bmdR = br - dr, bmdI = bi - di;
+
+                size_t out = q + static_cast<size_t>(stride) * p * 4;
+                yr[out] = apcR + bpdR;
+                yi[out] = apcI + bpdI;
+
+                float t1r = amcR + bmdI, t1i = amcI - bmdR;
+                yr[out + stride] = t1r * w1r - t1i * w1i;
+                yi[out + stride] = t1r * w1i + t1i * w1r;
+
+                float t2r = apcR - bpdR, t2i = apcI - bpdI;
+                yr[out + stride * 2] = t2r * w2r - t2i * w2i;
+                yi[out + stride * 2] = t2r * w2i + t2i * w2r;
+
+                float t3r = amcR - bmdI, t3i = amcI + bmdR;
+                yr[out + stride * 3] = t3r * w3r - t3i * w3i;
+                yi[out + stride * 3] = t3r * w3i + t3i * w3r;
+            }
+        }
+    }
+
+    void Radix4SSE2(int length, int stride, const float* xr, const float* xi, float* yr, float* yi, const float* twiddles)
+    {
+        if (stride == 1)
+        {
+            Radix4FirstPassSSE2(length, xr, xi, yr, yi, twiddles);
+            return;
+        }
+
+        const int quarter = length / 4;
+        const size_t step = static_cast<size_t>(stride) * quarter;
+
+        for (int p = 0; p < quarter; ++p)
+        {
+            __m128 w1r = _mm_set1_ps(twiddles[p]), w1i = _mm_set1_ps(twiddles[quarter + p]);
+            __m128 w2r = _mm_set1_ps(twiddles[quarter * 2 + p]), w2i = _mm_set1_ps(twiddles[quarter * 3 + p]);
+            __m128 w3r = _mm_set1_ps(twiddles[quarter * 4 + p]), w3i = _mm_set1_ps(twiddles[quarter * 5 + p]);
+
+            const float* inR = xr + static_cast<size_t>(stride) * p;
+            const float* inI = xi + static_cast<size_t>(stride) * p;
+            float* outR = yr + static_cast<size_t>(stride) * p * 4;
+            float* outI = yi + static_cast<size_t>(stride) * p * 4;
+
+            for (int q = 0; q < stride; q += 4)
+            {
+                __m128 y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i;
+                ButterflySSE2(
+                    _mm_load_ps(inR + q), _mm_load_ps(inI + q),
+                    _mm_load_ps(inR + q + step), _mm_load_ps(inI + q + step),
+                    _mm_load_ps(inR + q + step * 2), _mm_load_ps(inI + q + step * 2),
+                    _mm_load_ps(inR + q + step * 3), _mm_load_ps(inI + q + step * 3),
+                    w1r, w1i, w2r, w2i, w3r, w3i,
+                    y0r, y0i, y1r, y1i, y2r, y2i, y3r, y3i);
+
+                _mm_store_ps(outR + q, y0r);
+                _mm_store_ps(outI + q, y0i);
+                _mm_store_ps(outR + q + stride, y1r);
+                _mm_store_ps(outI + q + stride, y1i);
+                _mm_store_ps(outR + q + stride * 2, y2r);
+                _mm_store_ps(outI + q + stride * 2, y2i);
+                _mm_store_ps(outR + q + stride * 3, y3r);
+                _mm_store_ps(outI + q + stride * 3, y3i);
+            }
+        }
+    }
+}
+
+RealFFT::RealFFT(int fftSize)
+    : m_size(0)
+{
+    if (!IsSupportedSize(fftSize))
+        return;
+
+    m_size = fftSize;
+    const int half = fftSize / 2;
+
+    // Pass plan and twiddles, computed in double and rounded once
+    size_t twiddleCount = 0;
+    for (int length = half; length >= 4; length /= 4)
+    {
+        m_passes.push_back({ length, half / length, twiddleCount });
+        twiddleCount += static_cast<size_t>(length / 4) * 6;
+    }
+    if (m_passes.empty() || m_passes.back().length != 4)
+    {
+        // log2(N/2) is odd: finish with a radix-2 pass over pairs
+        m_passes.push_back({ 2, half / 2, twiddleCount });
+    }
+
+    m_twiddles.resize(twiddleCount);
+    for (const Pass& pass : m_passes)
+    {
+        if (pass.length < 4)
+            continue;
+
+        const int quarter = pass.length / 4;
+        float* table = &m_twiddles[pass.twiddleIndex];
+        for (int p = 0; p < quarter; ++p)
+        {
+            for (int k = 1; k <= 3; ++k)
+            {
+                double angle = -2.0 * Pi * k * p / pass.length;
+                table[quarter * (k - 1) * 2 + p] = static_cast<float>(cos(angle));
+                table[quarter * ((k - 1) * 2 + 1) + p] = static_cast<float>(sin(angle));
+            }
+        }
+    }
+
+    m_postTwiddles.resize(static_cast<size_t>(half) * 2);
+    for (int k = 0; k < half; ++k)
+    {
+        double angle = -2.0 * Pi * k / fftSize;
+        m_postTwiddles[k] = static_cast<float>(cos(angle));
+        m_postTwiddles[half + k] = static_cast<float>(sin(angle));
+    }
+
+    m_scratch.resize(GetScratchSize());
+}
+
+bool RealFFT::IsSupportedSize(int fftSize)
+{
+    return fftSize >= MinSize && fftSize <= MaxSize && (fftSize & (fftSize - 1)) == 0;
+}
+
+void RealFFT::Forward(const float* input, FFTComplex* output)
+{
+    Forward(input, output, m_scratch.data());
+}
+
+void RealFFT::Forward(const float* input, FFTComplex* output, float* scratch) const
+{
+    const int half = m_size / 2;
+    const SIMDLevel level = PCMConvert::GetActiveLevel();
+
+    // Two split buffers to ping-pong between
+    float* xr = scratch;
+    float* xi = scratch + half;
+    float* yr = scratch + half * 2;
+    float* yi = scratch + half * 3;
+
+    // Pack even samples as real and odd samples as imaginary parts: z[n] = x[2n] + i x[2n+1]
+    int n = 0;
+    if (level != SIMDLevel::Scalar)
+    {
+        for (; n < half; n += 4)
+        {
+            __m128 low = _mm_loadu_ps(input + n * 2);
+            __m128 high = _mm_loadu_ps(input + n * 2 + 4);
+            _mm_store_ps(xr + n, _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_store_ps(xi + n, _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+    }
+    for (; n < half; ++n)
+    {
+        xr[n] = input[n * 2];
+        xi[n] = input[n * 2 + 1];
+    }
+
+    for (const Pass& pass : m_passes)
+    {
+        if (pass.length == 2)
+        {
+            if (level == SIMDLevel::AVX2)
+                RealFFTKernels::Radix2AVX2(pass.stride, xr, xi, yr, yi);
+            else if (level == SIMDLevel::SSE2)
+                Radix2SSE2(pass.stride, xr, xi, yr, yi);
+            else
+                Radix2Scalar(pass.stride, xr, xi, yr, yi);
+        }
+        else
+        {
+            const float* twiddles = &m_twiddles[pass.twiddleIndex];
+            if (level == SIMDLevel::AVX2 && pass.stride >= 8)
+                RealFFTKernels::Radix4AVX2(pass.length, pass.stride, xr, xi, yr, yi, twiddles);
+            else if (level != SIMDLevel::Scalar)
+                RealFFTKernels::Radix4SSE2(pass.length, pass.stride, xr, xi, yr, yi, twiddles);
+            else
+                RealFFTKernels::Radix4Scalar(pass.length, pass.stride, xr, xi, yr, yi, twiddles);
+        }
+
+        std::swap(xr, yr);
+        std::swap(xi, yi);
+    }
+
+    // Untangle Z = FFT(z) into the real spectrum:
+    //   X[k] = (Z[k] + conj(Z[M-k])) / 2 - i W^k (Z[k] - conj(Z[M-k])) / 2,  M = N/2, W = exp(-2 pi i / N)
+    const float* wr = m_postTwiddles.data();
+    const float* wi = m_postTwiddles.data() + half;
+    float* bins = &output[0][0];
+
+    bins[0] = xr[0] + xi[0];
+    bins[1] = 0.0f;
+    bins[half * 2] = xr[0] - xi[0];
+    bins[half * 2 + 1] = 0.0f;
+
+    int k = 1;
+    if (level != SIMDLevel::Scalar)
+    {
+        const __m128 halfScale = _mm_set1_ps(0.5f);
+        for (; k + 4 <= half; k += 4)
+        {
+            // Z[M-k] for the four k, loaded as Z[M-k-3 .. M-k] and reversed
+            __m128 cr = _mm_loadu_ps(xr + half - k - 3);
+            __m128 ci = _mm_loadu_ps(xi + half - k - 3);
+            cr = _mm_shuffle_ps(cr, cr, _MM_SHUFFLE(0, 1, 2, 3));
+            ci = _mm_shuffle_ps(ci, ci, _MM_SHUFFLE(0, 1, 2, 3));
+            __m128 ar = _mm_loadu_ps(xr + k);
+            __m128 ai = _mm_loadu_ps(xi + k);
+
+            __m128 evenR = _mm_mul_ps(_mm_add_ps(ar, cr), halfScale);
+            __m128 evenI = _mm_mul_ps(_mm_sub_ps(ai, ci), halfScale);
+            __m128 oddR = _mm_mul_ps(_mm_add_ps(ai, ci), halfScale);
+            __m128 oddI = _mm_mul_ps(_mm_sub_ps(cr, ar), halfScale);
+
+            __m128 twR = _mm_loadu_ps(wr + k);
+            __m128 twI = _mm_loadu_ps(wi + k);
+            __m128 outR = _mm_add_ps(evenR, _mm_sub_ps(_mm_mul_ps(twR, oddR), _mm_mul_ps(twI, oddI)));
+            __m128 outI = _mm_add_ps(evenI, _mm_add_ps(_mm_mul_ps(twR, oddI), _mm_mul_ps(twI, oddR)));
+
+            _mm_storeu_ps(bins + k * 2, _mm_unpacklo_ps(outR, outI));
+            _mm_storeu_ps(bins + k * 2 + 4, _mm_unpackhi_ps(outR, outI));
+        }
+    }
+    for (; k < half; ++k)
+    {
+        float ar = xr[k], ai = xi[k];
+        float cr = xr[half - k], ci = xi[half - k];
+
+        float evenR = (ar + cr) * 0.5f, evenI = (ai - ci) * 0.5f;
+        float oddR = (ai + ci) * 0.5f, oddI = (cr - ar) * 0.5f;
+
+        bins[k * 2] = evenR + wr[k] * oddR - wi[k] * oddI;
+        bins[k * 2 + 1] = evenI + wr[k] * oddI + wi[k] * oddR;
+    }
+}
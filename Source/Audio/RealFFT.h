@@ -0,0 +1,50 @@
+#pragma once
+#include "../Utils/AlignedAllocator.h"
+#include <vector>
+
+// Interleaved complex bin (re, im); same layout as fftwf_complex
+typedef float FFTComplex[2];
+
+// In-tree real-input FFT for power-of-two sizes from 256 to 65536, used by FFTProcessor
+// when FFTW is not built in or cannot plan. A real N-point transform runs as an N/2-point
+// complex Stockham FFT in split re/im form (radix-4 passes, plus one radix-2 pass when
+// log2(N/2) is odd), then a single post-pass separates the even and odd halves into the
+// N/2 + 1 bins of the real spectrum. Passes use SSE2, or AVX2 where the stride allows,
+// following PCMConvert's active SIMD level.
+class RealFFT
+{
+public:
+    explicit RealFFT(int fftSize);
+
+    static bool IsSupportedSize(int fftSize);
+
+    bool IsValid() const { return m_size > 0; }
+    int GetFFTSize() const { return m_size; }
+    int GetBinCount() const { return m_size / 2 + 1; }
+
+    // Floats of scratch a Forward() call needs
+    size_t GetScratchSize() const { return static_cast<size_t>(m_size) * 2; }
+
+    // N samples in, N/2 + 1 bins out, unnormalised like FFTW. The scratch overload is
+    // thread safe ('scratch' 16-byte aligned, GetScratchSize() floats); the other uses
+    // an internal buffer.
+    void Forward(const float* input, FFTComplex* output);
+    void Forward(const float* input, FFTComplex* output, float* scratch) const;
+
+    static constexpr int MinSize = 256;
+    static constexpr int MaxSize = 65536;
+
+private:
+    struct Pass
+    {
+        int length;          // Points per sub-transform (n)
+        int stride;          // Interleaved sub-transforms (s); length * stride == N/2
+        size_t twiddleIndex; // Six arrays of length / 4 floats: w1 re/im, w2 re/im, w3 re/im
+    };
+
+    int m_size;
+    std::vector<Pass> m_passes;
+    AlignedVector<float> m_twiddles;
+    AlignedVector<float> m_postTwiddles; // exp(-2 pi i k / N): N/2 re, then N/2 im
+    AlignedVector<float> m_scratch;
+};
@@ -0,0 +1,74 @@
+#include "RealFFTKernels.h"
+#include <immintrin.h>
+
+// Built with /arch:AVX2; only reached when PCMConvert detected AVX2 support at runtime
+
+namespace
+{
+    inline void Multiply(__m256 ar, __m256 ai, __m256 br, __m256 bi, __m256& outR, __m256& outI)
+    {
+        outR = _mm256_sub_ps(_mm256_mul_ps(ar, br), _mm256_mul_ps(ai, bi));
+        outI = _mm256_add_ps(_mm256_mul_ps(ar, bi), _mm256_mul_ps(ai, br));
+    }
+}
+
+namespace RealFFTKernels
+{
+    void Radix4AVX2(int length, int stride, const float* xr, const float* xi, float* yr, float* yi, const float* twiddles)
+    {
+        const int quarter = length / 4;
+        const size_t step = static_cast<size_t>(stride) * quarter;
+
+        for (int p = 0; p < quarter; ++p)
+        {
+            __m256 w1r = _mm256_set1_ps(twiddles[p]), w1i = _mm256_set1_ps(twiddles[quarter + p]);
+            __m256 w2r = _mm256_set1_ps(twiddles[quarter * 2 + p]), w2i = _mm256_set1_ps(twiddles[quarter * 3 + p]);
+            __m256 w3r = _mm256_set1_ps(twiddles[quarter * 4 + p]), w3i = _mm256_set1_ps(twiddles[quarter * 5 + p]);
+
+            const float* inR = xr + static_cast<size_t>(stride) * p;
+            const float* inI = xi + static_cast<size_t>(stride) * p;
+            float* outR = yr + static_cast<size_t>(stride) * p * 4;
+            float* outI = yi + static_cast<size_t>(stride) * p * 4;
+
+            for (int q = 0; q < stride; q += 8)
+            {
+                __m256 ar = _mm256_loadu_ps(inR + q), ai = _mm256_loadu_ps(inI + q);
+                __m256 br = _mm256_loadu_ps(inR + q + step), bi = _mm256_loadu_ps(inI + q + step);
+                __m256 cr = _mm256_loadu_ps(inR + q + step * 2), ci = _mm256_loadu_ps(inI + q + step * 2);
+                __m256 dr = _mm256_loadu_ps(inR + q + step * 3), di = _mm256_loadu_ps(inI + q + step * 3);
+
+                __m256 apcR = _mm256_add_ps(ar, cr), apcI = _mm256_add_ps(ai, ci);
+                __m256 amcR = _mm256_sub_ps(ar, cr), amcI = _mm256_sub_ps(ai, ci);
+                __m256 bpdR = _mm256_add_ps(br, dr), bpdI = _mm256_add_ps(bi, di);
+                __m256 bmdR = _mm256_sub_ps(br, dr), bmdI = _mm256_sub_ps(bi, di);
+
+                __m256 y1r, y1i, y2r, y2i, y3r, y3i;
+                Multiply(_mm256_add_ps(amcR, bmdI), _mm256_sub_ps(amcI, bmdR), w1r, w1i, y1r, y1i);
+                Multiply(_mm256_sub_ps(apcR, bpdR), _mm256_sub_ps(apcI, bpdI), w2r, w2i, y2r, y2i);
+                Multiply(_mm256_sub_ps(amcR, bmdI), _mm256_add_ps(amcI, bmdR), w3r, w3i, y3r, y3i);
+
+                _mm256_storeu_ps(outR + q, _mm256_add_ps(apcR, bpdR));
+                _mm256_storeu_ps(outI + q, _mm256_add_ps(apcI, bpdI));
+                _mm256_storeu_ps(outR + q + stride, y1r);
+                _mm256_storeu_ps(outI + q + stride, y1i);
+                _mm256_storeu_ps(outR + q + stride * 2, y2r);
+                _mm256_storeu_ps(outI + q + stride * 2, y2i);
+                _mm256_storeu_ps(outR + q + stride * 3, y3r);
+                _mm256_storeu_ps(outI + q + stride * 3, y3i);
+            }
+        }
+    }
+
+    void Radix2AVX2(int stride, const float* xr, const float* xi, float* yr, float* yi)
+    {
+        for (int q = 0; q < stride; q += 8)
+        {
+            __m256 ar = _mm256_loadu_ps(xr + q), ai = _mm256_loadu_ps(xi + q);
+            __m256 br = _mm256_loadu_ps(xr + q + stride), bi = _mm256_loadu_ps(xi + q + stride);
+            _mm256_storeu_ps(yr + q, _mm256_add_ps(ar, br));
+            _mm256_storeu_ps(yi + q, _mm256_add_ps(ai, bi));
+            _mm256_storeu_ps(yr + q + stride, _mm256_sub_ps(ar, br));
+            _mm256_storeu_ps(yi + q + stride, _mm256_sub_ps(ai, bi));
+        }
+    }
+}
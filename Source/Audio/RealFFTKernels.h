@@ -0,0 +1,16 @@
+#pragma once
+#include "RealFFT.h"
+
+// Pass kernels shared by RealFFT.cpp and the AVX2 translation unit. Every pass reads the
+// split complex signal (xr, xi) of N/2 points and writes (yr, yi); see RealFFT.cpp for
+// the Stockham indexing.
+namespace RealFFTKernels
+{
+    // Radix-4 pass; 'twiddles' is the pass's six arrays of length / 4
+    void Radix4Scalar(int length, int stride, const float* xr, const float* xi, float* yr, float* yi, const float* twiddles);
+    void Radix4SSE2(int length, int stride, const float* xr, const float* xi, float* yr, float* yi, const float* twiddles);
+    void Radix4AVX2(int length, int stride, const float* xr, const float* xi, float* yr, float* yi, const float* twiddles); // stride >= 8
+
+    // Final radix-2 pass (length 2, no twiddles)
+    void Radix2AVX2(int stride, const float* xr, const float* xi, float* yr, float* yi); // stride >= 8
+}
@@ -0,0 +1,192 @@
+#include "Resampler.h"
+#include "PCMConvert.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <emmintrin.h>
+
+namespace
+{
+    // Zeroth-order modified Bessel function of the first kind, for the Kaiser window
+    double BesselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (int k = 1; k < 32; k++)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < sum * 1e-12)
+                break;
+        }
+        return sum;
+    }
+
+    float DotScalar(const float* a, const float* b, int count)
+    {
+        float sum = 0.0f;
+        for (int i = 0; i < count; i++)
+        {
+            sum += a[i] * b[i];
+        }
+        return sum;
+    }
+
+    // 'count' is a multiple of 4
+    float DotSSE2(const float* a, const float* b, int count)
+    {
+        __m128 sum0 = _mm_setzero_ps();
+        __m128 sum1 = _mm_setzero_ps();
+        int i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+        }
+        for (; i < count; i += 4)
+        {
+            sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        }
+
+        __m128 sum = _mm_add_ps(sum0, sum1);
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+        return _mm_cvtss_f32(sum);
+    }
+}
+
+Resampler::Resampler()
+    : m_inputRate(0), m_outputRate(0), m_interpolation(1), m_decimation(1), m_taps(0), m_inputIndex(0), m_phase(0)
+{
+}
+
+bool Resampler::Initialize(int inputRate, int outputRate, ResampleQuality quality)
+{
+    m_inputRate = inputRate;
+    m_outputRate = outputRate;
+    m_interpolation = 1;
+    m_decimation = 1;
+    m_taps = 0;
+    m_coefficients.clear();
+    m_history.clear();
+
+    if (inputRate <= 0 || outputRate <= 0)
+        return false;
+
+    if (inputRate == outputRate)
+        return true;
+
+    int divisor = std::gcd(inputRate, outputRate);
+    int interpolation = outputRate / divisor;
+    int decimation = inputRate / divisor;
+    if (interpolation > MaxPhases)
+    {
+        std::cout << "Resampler: unsupported ratio " << inputRate << " -> " << outputRate << " Hz" << std::endl;
+        return false;
+    }
+
+    m_interpolation = interpolation;
+    m_decimation = decimation;
+
+    // When decimating, the cutoff drops by M/L, so the filter needs proportionally more
+    // input taps for the same transition width
+    int scale = (decimation + interpolation - 1) / interpolation;
+
+    switch (quality)
+    {
+    case ResampleQuality::Fast:     DesignFilter(16 * scale, 0.90f, 6.0f); break;
+    case ResampleQuality::Balanced: DesignFilter(32 * scale, 0.94f, 8.0f); break;
+    case ResampleQuality::High:     DesignFilter(64 * scale, 0.97f, 10.0f); break;
+    }
+
+    Reset();
+
+    std::cout << "Resampler " << inputRate << " -> " << outputRate << " Hz: " << m_interpolation << "/" << m_decimation
+        << ", " << m_interpolation << " phases x " << m_taps << " taps" << std::endl;
+    return true;
+}
+
+void Resampler::DesignFilter(int tapsPerPhase, float passband, float beta)
+{
+    m_taps = tapsPerPhase;
+    const int length = m_taps * m_interpolation;
+
+    // Cutoff relative to the upsampled rate: the lower of the two Nyquist limits,
+    // pulled in slightly so the transition band ends before it
+    const double cutoff = 0.5 * passband * std::min(1.0, static_cast<double>(m_interpolation) / m_decimation) / m_interpolation;
+    const double center = (length - 1) * 0.5;
+    const double windowScale = 1.0 / BesselI0(beta);
+    const double pi = 3.14159265358979323846;
+
+    std::vector<double> prototype(length);
+    for (int i = 0; i < length; i++)
+    {
+        double t = i - center;
+        double sinc = t == 0.0 ? 2.0 * cutoff : sin(2.0 * pi * cutoff * t) / (pi * t);
+        double ratio = t / (center + 0.5);
+        double window = BesselI0(beta * sqrt(std::max(0.0, 1.0 - ratio * ratio))) * windowScale;
+        prototype[i] = sinc * window * m_interpolation; // Gain of L makes up for the zero stuffing
+    }
+
+    // Phase p uses prototype[p + k * L]; store it time-reversed so the dot product runs
+    // forwards over the input history
+    m_coefficients.resize(static_cast<size_t>(length));
+    for (int phase = 0; phase < m_interpolation; phase++)
+    {
+        float* row = &m_coefficients[static_cast<size_t>(phase) * m_taps];
+        for (int k = 0; k < m_taps; k++)
+        {
+            row[m_taps - 1 - k] = static_cast<float>(prototype[phase + k * m_interpolation]);
+        }
+    }
+}
+
+void Resampler::Reset()
+{
+    m_history.assign(m_taps > 0 ? m_taps - 1 : 0, 0.0f);
+    m_inputIndex = m_history.size();
+    m_phase = 0;
+}
+
+size_t Resampler::GetMaxOutput(size_t inputCount) const
+{
+    if (!IsActive())
+        return inputCount;
+
+    return (inputCount + 1) * m_interpolation / m_decimation + 1;
+}
+
+size_t Resampler::Process(const float* input, size_t inputCount, float* output)
+{
+    if (!IsActive())
+    {
+        std::copy(input, input + inputCount, output);
+        return inputCount;
+    }
+
+    m_history.insert(m_history.end(), input, input + inputCount);
+
+    auto dot = PCMConvert::GetActiveLevel() == SIMDLevel::Scalar ? DotScalar : DotSSE2;
+    const size_t historySize = m_history.size();
+    const float* history = m_history.data();
+    size_t written = 0;
+
+    while (m_inputIndex < historySize)
+    {
+        const float* row = &m_coefficients[static_cast<size_t>(m_phase) * m_taps];
+        output[written++] = dot(row, history + m_inputIndex - (m_taps - 1), m_taps);
+
+        m_phase += m_decimation;
+        m_inputIndex += m_phase / m_interpolation;
+        m_phase %= m_interpolation;
+    }
+
+    // Keep the taps - 1 samples the next output still needs; when decimating hard the
+    // next output can lie beyond this block, which m_inputIndex keeps track of
+    size_t keepFrom = std::min(m_inputIndex - (m_taps - 1), historySize);
+    m_history.erase(m_history.begin(), m_history.begin() + keepFrom);
+    m_inputIndex -= keepFrom;
+
+    return written;
+}
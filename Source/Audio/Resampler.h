@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+enum class ResampleQuality
+{
+    Fast,     // 16 taps per phase, ~90% passband (taps scale up when decimating)
+    Balanced, // 32 taps per phase, ~94% passband
+    High      // 64 taps per phase, ~97% passband
+};
+
+// Streaming polyphase resampler for one channel of float samples. The rate ratio is
+// reduced to L/M and a Kaiser-windowed sinc is split into L phases, so every output
+// sample is a single dot product over the input history. State carries over between
+// Process() calls; call Reset() after a seek.
+class Resampler
+{
+public:
+    Resampler();
+
+    // Returns false for ratios that would need an impractical number of phases
+    bool Initialize(int inputRate, int outputRate, ResampleQuality quality = ResampleQuality::Balanced);
+    void Reset();
+
+    // Pass-through when both rates match (or Initialize failed)
+    bool IsActive() const { return !m_coefficients.empty(); }
+
+    // Upper bound on the samples Process() writes for 'inputCount' input samples
+    size_t GetMaxOutput(size_t inputCount) const;
+
+    // Consumes every input sample and returns the number of samples written to 'output'
+    size_t Process(const float* input, size_t inputCount, float* output);
+
+    int GetInputRate() const { return m_inputRate; }
+    int GetOutputRate() const { return m_outputRate; }
+    int GetTapsPerPhase() const { return m_taps; }
+    int GetPhaseCount() const { return m_interpolation; }
+
+private:
+    void DesignFilter(int tapsPerPhase, float passband, float beta);
+
+    static constexpr int MaxPhases = 4096;
+
+    int m_inputRate;
+    int m_outputRate;
+    int m_interpolation; // L
+    int m_decimation;    // M
+    int m_taps;          // Per phase, multiple of 4
+
+    std::vector<float> m_coefficients; // m_interpolation rows of m_taps, time-reversed
+    std::vector<float> m_history;      // Last m_taps - 1 inputs followed by the current block
+    size_t m_inputIndex;               // Newest input sample of the next output, into m_history
+    int m_phase;
+};
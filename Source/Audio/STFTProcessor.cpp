@@ -0,0 +1,138 @@
+#include "STFTProcessor.h"
+#include <algorithm>
+#include <iostream>
+
+STFTProcessor::STFTProcessor(int windowSize, int hopSize, size_t queueCapacity)
+    : m_windowSize(0), m_hopSize(0), m_sampleRate(48000), m_startTime(0.0), m_outputs(FFTOutputFlags::Magnitude),
+      m_writePos(0), m_sinceLastFrame(0), m_samplesPushed(0), m_queue(std::max<size_t>(queueCapacity, 2)),
+      m_head(0), m_queued(0), m_framesProduced(0), m_framesDropped(0)
+{
+    if (!Configure(windowSize, hopSize))
+    {
+        Configure(4096, 1024);
+    }
+}
+
+STFTProcessor::~STFTProcessor()
+{
+}
+
+bool STFTProcessor::IsValidHop(int windowSize, int hopSize)
+{
+    return windowSize >= 8 && hopSize > 0 && hopSize * 8 >= windowSize && hopSize * 2 <= windowSize;
+}
+
+bool STFTProcessor::Configure(int windowSize, int hopSize)
+{
+    if (!IsValidHop(windowSize, hopSize))
+    {
+        std::cout << "STFT hop " << hopSize << " is outside 50-87.5% overlap for a " << windowSize << " window" << std::endl;
+        return false;
+    }
+
+    if (!m_fft || m_fft->GetFFTSize() != windowSize)
+    {
+        m_fft = std::make_unique<FFTProcessor>(windowSize);
+    }
+
+    m_windowSize = windowSize;
+    m_hopSize = hopSize;
+    m_history.assign(static_cast<size_t>(windowSize) * 2, 0.0f);
+    Reset(m_sampleRate, 0.0);
+    return true;
+}
+
+void STFTProcessor::Reset(int sampleRate, double startTime)
+{
+    m_sampleRate = sampleRate > 0 ? sampleRate : m_sampleRate;
+    m_startTime = startTime;
+
+    // Start from silence so the first frame comes one hop in rather than a whole window
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_writePos = 0;
+    m_sinceLastFrame = 0;
+    m_samplesPushed = 0;
+
+    m_head = 0;
+    m_queued = 0;
+}
+
+size_t STFTProcessor::Push(const float* samples, size_t count)
+{
+    size_t produced = 0;
+    const size_t windowSize = m_windowSize;
+
+    while (count > 0)
+    {
+        // Copy up to the next frame boundary (and never across the end of the ring)
+        size_t block = std::min<size_t>(count, m_hopSize - m_sinceLastFrame);
+        block = std::min(block, windowSize - m_writePos);
+
+        std::copy(samples, samples + block, m_history.begin() + m_writePos);
+        std::copy(samples, samples + block, m_history.begin() + m_writePos + windowSize);
+
+        m_writePos = (m_writePos + block) % windowSize;
+        m_sinceLastFrame += static_cast<int>(block);
+        m_samplesPushed += block;
+        samples += block;
+        count -= block;
+
+        if (m_sinceLastFrame == m_hopSize)
+        {
+            ProcessWindow();
+            m_sinceLastFrame = 0;
+            produced++;
+        }
+    }
+
+    return produced;
+}
+
+void STFTProcessor::ProcessWindow()
+{
+    if (m_queued == m_queue.size())
+    {
+        m_head = (m_head + 1) % m_queue.size();
+        m_queued--;
+        m_framesDropped++;
+    }
+
+    SpectralFrame& frame = m_queue[(m_head + m_queued) % m_queue.size()];
+    m_queued++;
+
+    // Window centre, in seconds; the first frames include the silence the history started with
+    double centre = static_cast<double>(m_samplesPushed) - m_windowSize * 0.5;
+    frame.index = m_framesProduced++;
+    frame.time = m_startTime + centre / m_sampleRate;
+
+    Span<const float> window(m_history.data() + m_writePos, m_windowSize);
+    m_fft->ProcessFFT(window, frame.result, m_outputs);
+}
+
+const SpectralFrame* STFTProcessor::GetFrameAt(double time)
+{
+    if (m_queued == 0)
+        return nullptr;
+
+    // Release every frame that has a newer one still at or before 'time'
+    while (m_queued > 1 && m_queue[(m_head + 1) % m_queue.size()].time <= time)
+    {
+        m_head = (m_head + 1) % m_queue.size();
+        m_queued--;
+    }
+
+    return &m_queue[m_head];
+}
+
+const SpectralFrame* STFTProcessor::GetFrameByIndex(uint64_t index) const
+{
+    if (m_queued == 0)
+        return nullptr;
+
+    // Queued frames carry consecutive indices from the head on
+    const uint64_t first = m_queue[m_head].index;
+    if (index < first || index - first >= m_queued)
+        return nullptr;
+
+    return &m_queue[(m_head + static_cast<size_t>(index - first)) % m_queue.size()];
+}
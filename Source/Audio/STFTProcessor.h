@@ -0,0 +1,84 @@
+#pragma once
+#include "FFTProcessor.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// One analysed window. 'time' is the centre of the window in seconds of input.
+struct SpectralFrame
+{
+    uint64_t index = 0;
+    double time = 0.0;
+    FFTResult result;
+};
+
+// Streaming short-time Fourier transform. Samples are pushed in whatever block size the
+// caller has; every 'hop' samples the last 'window' samples are transformed, so spectra
+// always cover a full window and the FFT rate follows the hop, not the display rate.
+// Frames wait in a bounded queue until the consumer samples them by time. The oldest
+// frame is dropped when the queue is full.
+// Not thread safe: push and read from the same thread.
+class STFTProcessor
+{
+public:
+    STFTProcessor(int windowSize = 4096, int hopSize = 1024, size_t queueCapacity = 32);
+    ~STFTProcessor();
+
+    // Overlap must stay within 50-87.5%, i.e. window / 8 <= hop <= window / 2.
+    // Returns false and keeps the current setup otherwise. Clears history and queue.
+    bool Configure(int windowSize, int hopSize);
+
+    // Clears history and queue; the next pushed sample is at 'startTime' seconds
+    void Reset(int sampleRate, double startTime = 0.0);
+
+    // Which spectra each frame carries (magnitudes by default)
+    void SetOutputs(FFTOutputFlags outputs) { m_outputs = outputs; }
+
+    // Returns the number of frames produced
+    size_t Push(const float* samples, size_t count);
+
+    // Newest queued frame whose time is at or before 'time' (the oldest one if all are
+    // later), nullptr when nothing has been produced yet. Older frames are released; the
+    // returned frame stays valid until the next Push().
+    const SpectralFrame* GetFrameAt(double time);
+
+    // Queued frame with the given index (frames are numbered from 0 in production order),
+    // nullptr once it has been dropped or released. Valid until the next Push().
+    const SpectralFrame* GetFrameByIndex(uint64_t index) const;
+
+    int GetWindowSize() const { return m_windowSize; }
+    int GetHopSize() const { return m_hopSize; }
+    float GetOverlap() const { return 1.0f - static_cast<float>(m_hopSize) / m_windowSize; }
+    int GetSampleRate() const { return m_sampleRate; }
+    size_t GetQueuedFrames() const { return m_queued; }
+    uint64_t GetFramesProduced() const { return m_framesProduced; }
+    uint64_t GetFramesDropped() const { return m_framesDropped; }
+
+    FFTProcessor& GetFFT() { return *m_fft; }
+    const FFTProcessor& GetFFT() const { return *m_fft; }
+
+    static bool IsValidHop(int windowSize, int hopSize);
+
+private:
+    void ProcessWindow();
+
+    int m_windowSize;
+    int m_hopSize;
+    int m_sampleRate;
+    double m_startTime;
+    FFTOutputFlags m_outputs;
+    std::unique_ptr<FFTProcessor> m_fft;
+
+    // Every sample is written twice, 'window' apart, so the latest window is always one
+    // contiguous span ending at m_writePos + window
+    std::vector<float> m_history;
+    size_t m_writePos;
+    int m_sinceLastFrame;
+    uint64_t m_samplesPushed;
+
+    std::vector<SpectralFrame> m_queue; // Ring of reused frames
+    size_t m_head;   // Oldest queued frame
+    size_t m_queued;
+    uint64_t m_framesProduced;
+    uint64_t m_framesDropped;
+};
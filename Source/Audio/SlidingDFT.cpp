@@ -0,0 +1,205 @@
+#include "SlidingDFT.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <emmintrin.h>
+
+namespace
+{
+    const double Pi = 3.14159265358979323846;
+
+    // Samples per pass over the resonators; bounds the delta buffer
+    const size_t BlockSize = 256;
+}
+
+SlidingDFT::SlidingDFT(int windowSize)
+    : m_windowSize(0), m_sampleRate(48000), m_startTime(0.0), m_samplesPushed(0), m_historyPos(0),
+      m_dampingN(1.0f), m_back(0), m_front(1), m_middle(2)
+{
+    Configure(windowSize, {});
+}
+
+bool SlidingDFT::Configure(int windowSize, const std::vector<int>& bins)
+{
+    if (windowSize < 8)
+    {
+        std::cout << "Sliding DFT window " << windowSize << " is too small" << std::endl;
+        return false;
+    }
+
+    m_windowSize = windowSize;
+    const int binCount = windowSize / 2 + 1;
+
+    // Requested bins plus their neighbours for the Hann window; past either end the
+    // neighbour is the conjugate of the bin inside
+    m_outputBins.clear();
+    m_trackedBins.clear();
+    for (int bin : bins)
+    {
+        if (bin < 0 || bin >= binCount)
+            continue;
+
+        m_outputBins.push_back(bin);
+        for (int neighbour : { bin - 1, bin, bin + 1 })
+        {
+            int mirrored = neighbour < 0 ? -neighbour : neighbour >= binCount ? 2 * (binCount - 1) - neighbour : neighbour;
+            m_trackedBins.push_back(mirrored);
+        }
+    }
+    std::sort(m_outputBins.begin(), m_outputBins.end());
+    m_outputBins.erase(std::unique(m_outputBins.begin(), m_outputBins.end()), m_outputBins.end());
+    std::sort(m_trackedBins.begin(), m_trackedBins.end());
+    m_trackedBins.erase(std::unique(m_trackedBins.begin(), m_trackedBins.end()), m_trackedBins.end());
+
+    m_slotOfBin.assign(binCount, -1);
+    const size_t slots = (m_trackedBins.size() + 15) & ~static_cast<size_t>(15);
+    m_rotationCos.assign(slots, 0.0f);
+    m_rotationSin.assign(slots, 0.0f);
+    m_inputCos.assign(slots, 0.0f);
+    m_inputSin.assign(slots, 0.0f);
+    for (size_t slot = 0; slot < m_trackedBins.size(); ++slot)
+    {
+        int bin = m_trackedBins[slot];
+        m_slotOfBin[bin] = static_cast<int>(slot);
+
+        double angle = 2.0 * Pi * bin / windowSize;
+        m_inputCos[slot] = static_cast<float>(cos(angle));
+        m_inputSin[slot] = static_cast<float>(sin(angle));
+        m_rotationCos[slot] = static_cast<float>(Damping * cos(angle));
+        m_rotationSin[slot] = static_cast<float>(Damping * sin(angle));
+    }
+    m_real.assign(slots, 0.0f);
+    m_imag.assign(slots, 0.0f);
+
+    m_history.assign(windowSize, 0.0f);
+    m_delta.resize(BlockSize);
+    m_dampingN = static_cast<float>(pow(static_cast<double>(Damping), windowSize));
+
+    for (SpectralFrame& frame : m_frames)
+    {
+        frame.result.magnitudes.assign(binCount, 0.0f);
+        frame.result.maxMagnitude = 0.0f;
+        frame.result.sampleCount = windowSize;
+    }
+
+    Reset(m_sampleRate, 0.0);
+    return true;
+}
+
+void SlidingDFT::Reset(int sampleRate, double startTime)
+{
+    m_sampleRate = sampleRate > 0 ? sampleRate : m_sampleRate;
+    m_startTime = startTime;
+    m_samplesPushed = 0;
+
+    std::fill(m_real.begin(), m_real.end(), 0.0f);
+    std::fill(m_imag.begin(), m_imag.end(), 0.0f);
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_historyPos = 0;
+
+    Publish();
+}
+
+void SlidingDFT::Push(const float* samples, size_t count)
+{
+    while (count > 0)
+    {
+        size_t block = std::min(count, BlockSize);
+        ProcessBlock(samples, block);
+        samples += block;
+        count -= block;
+    }
+
+    Publish();
+}
+
+void SlidingDFT::ProcessBlock(const float* samples, size_t count)
+{
+    // Input term per sample, shared by every bin
+    for (size_t n = 0; n < count; ++n)
+    {
+        float& oldest = m_history[m_historyPos];
+        m_delta[n] = samples[n] - m_dampingN * oldest;
+        oldest = samples[n];
+        m_historyPos = m_historyPos + 1 == m_history.size() ? 0 : m_historyPos + 1;
+    }
+    m_samplesPushed += count;
+
+    // Bins outer, samples inner: the state of 16 bins stays in registers for the whole
+    // block, and the four independent groups hide the multiply-add latency
+    const size_t slots = m_real.size();
+    for (size_t slot = 0; slot < slots; slot += 16)
+    {
+        __m128 re[4], im[4], rc[4], rs[4], ic[4], is[4];
+        for (int g = 0; g < 4; ++g)
+        {
+            const size_t i = slot + g * 4;
+            re[g] = _mm_load_ps(&m_real[i]);
+            im[g] = _mm_load_ps(&m_imag[i]);
+            rc[g] = _mm_load_ps(&m_rotationCos[i]);
+            rs[g] = _mm_load_ps(&m_rotationSin[i]);
+            ic[g] = _mm_load_ps(&m_inputCos[i]);
+            is[g] = _mm_load_ps(&m_inputSin[i]);
+        }
+
+        for (size_t n = 0; n < count; ++n)
+        {
+            __m128 delta = _mm_set1_ps(m_delta[n]);
+            for (int g = 0; g < 4; ++g)
+            {
+                // e^(j theta) (r S + d) = r (re c - im s) + d c  +  j (r (re s + im c) + d s)
+                __m128 nextRe = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(re[g], rc[g]), _mm_mul_ps(im[g], rs[g])), _mm_mul_ps(delta, ic[g]));
+                __m128 nextIm = _mm_add_ps(_mm_add_ps(_mm_mul_ps(re[g], rs[g]), _mm_mul_ps(im[g], rc[g])), _mm_mul_ps(delta, is[g]));
+                re[g] = nextRe;
+                im[g] = nextIm;
+            }
+        }
+
+        for (int g = 0; g < 4; ++g)
+        {
+            _mm_store_ps(&m_real[slot + g * 4], re[g]);
+            _mm_store_ps(&m_imag[slot + g * 4], im[g]);
+        }
+    }
+}
+
+void SlidingDFT::Publish()
+{
+    SpectralFrame& frame = m_frames[m_back];
+    AlignedVector<float>& magnitudes = frame.result.magnitudes;
+    const int lastBin = m_windowSize / 2;
+    float maxMagnitude = 0.0f;
+
+    for (int bin : m_outputBins)
+    {
+        // Mirrored neighbours are conjugates: same real part, negated imaginary part
+        int below = m_slotOfBin[bin > 0 ? bin - 1 : 1];
+        int above = m_slotOfBin[bin < lastBin ? bin + 1 : lastBin - 1];
+        int centre = m_slotOfBin[bin];
+        float belowSign = bin > 0 ? 1.0f : -1.0f;
+        float aboveSign = bin < lastBin ? 1.0f : -1.0f;
+
+        float re = 0.5f * m_real[centre] - 0.25f * (m_real[below] + m_real[above]);
+        float im = 0.5f * m_imag[centre] - 0.25f * (belowSign * m_imag[below] + aboveSign * m_imag[above]);
+        float magnitude = sqrtf(re * re + im * im);
+
+        magnitudes[bin] = magnitude;
+        maxMagnitude = std::max(maxMagnitude, magnitude);
+    }
+
+    frame.result.maxMagnitude = maxMagnitude;
+    frame.index = m_samplesPushed;
+    frame.time = m_startTime + (static_cast<double>(m_samplesPushed) - m_windowSize * 0.5) / m_sampleRate;
+
+    m_back = m_middle.exchange(m_back | FreshBit, std::memory_order_acq_rel) & ~FreshBit;
+}
+
+const SpectralFrame* SlidingDFT::AcquireLatest()
+{
+    if (m_middle.load(std::memory_order_relaxed) & FreshBit)
+    {
+        m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & ~FreshBit;
+    }
+
+    return m_frames[m_front].result.magnitudes.empty() ? nullptr : &m_frames[m_front];
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "STFTProcessor.h"
+#include "../Utils/AlignedAllocator.h"
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+// Sliding DFT for low-latency band tracking. Instead of transforming a whole window
+// every hop, each tracked bin of the N-point spectrum is a damped resonator updated on
+// every sample:
+//     S_k <- e^(j 2pi k / N) * (r S_k + x[n] - r^N x[n - N])
+// so the cost is O(tracked bins) per sample and the spectrum is at most one pushed
+// block old. The Hann window is applied in the frequency domain as
+// 0.5 X[k] - 0.25 (X[k-1] + X[k+1]), which is why neighbouring bins are tracked too.
+//
+// Push() belongs to one thread. Each Push() publishes the spectrum through a triple
+// buffer that one other thread (or the same one) can take at any time without locks.
+class SlidingDFT
+{
+public:
+    explicit SlidingDFT(int windowSize = 2048);
+
+    // 'bins' are the spectrum bins to produce (e.g. FrequencyAnalyzer::GetBandBins);
+    // everything else reads as zero. Clears the state.
+    bool Configure(int windowSize, const std::vector<int>& bins);
+
+    // Clears history and state and publishes silence; the next pushed sample is at
+    // 'startTime' seconds
+    void Reset(int sampleRate, double startTime = 0.0);
+
+    void Push(const float* samples, size_t count);
+
+    // Latest published spectrum: magnitudes of GetWindowSize() / 2 + 1 bins, with 'time'
+    // the centre of the window. Owned by the reader until its next call; nullptr before
+    // Configure().
+    const SpectralFrame* AcquireLatest();
+
+    int GetWindowSize() const { return m_windowSize; }
+    int GetSampleRate() const { return m_sampleRate; }
+    size_t GetTrackedBinCount() const { return m_trackedBins.size(); }
+    uint64_t GetSamplesPushed() const { return m_samplesPushed; }
+
+    // Pole radius; keeps float rounding from accumulating in the resonators
+    static constexpr float Damping = 0.999999f;
+
+private:
+    void ProcessBlock(const float* samples, size_t count);
+    void Publish();
+
+    int m_windowSize;
+    int m_sampleRate;
+    double m_startTime;
+    uint64_t m_samplesPushed;
+
+    // Resonator state and rotation per tracked bin, split re/im and padded to a
+    // multiple of 16 (the SSE2 loop keeps four groups of four in flight)
+    std::vector<int> m_trackedBins;
+    std::vector<int> m_slotOfBin; // Spectrum bin -> tracked slot, -1 if untracked
+    std::vector<int> m_outputBins;
+    AlignedVector<float> m_real;
+    AlignedVector<float> m_imag;
+    AlignedVector<float> m_rotationCos; // r cos(2 pi k / N)
+    AlignedVector<float> m_rotationSin; // r sin(2 pi k / N)
+    AlignedVector<float> m_inputCos;    // cos(2 pi k / N), for the new input term
+    AlignedVector<float> m_inputSin;
+
+    std::vector<float> m_history; // Last N samples, for x[n - N]
+    size_t m_historyPos;
+    std::vector<float> m_delta;   // x[n] - r^N x[n - N] for the block being processed
+    float m_dampingN;             // r^N
+
+    // Triple buffer: the writer fills m_frames[m_back] and swaps it into m_middle; the
+    // reader swaps m_middle with m_front when the 'fresh' bit is set
+    SpectralFrame m_frames[3];
+    int m_back;
+    int m_front;
+    std::atomic<int> m_middle;
+    static constexpr int FreshBit = 4;
+};
@@ -0,0 +1,118 @@
+#include "Spectrogram.h"
+#include "../Utils/ThreadPool.h"
+#include <algorithm>
+#include <iostream>
+
+Spectrogram::Spectrogram()
+    : m_planBackend(FFTBackend::BuiltIn), m_frameCount(0), m_binCount(0), m_rowStride(0)
+{
+}
+
+Spectrogram::~Spectrogram()
+{
+}
+
+bool Spectrogram::Compute(Span<const float> samples, uint64_t frameCount, const FFTProcessor& fft, int hopSize,
+    const std::atomic<bool>* cancel)
+{
+    return Compute(samples, frameCount, fft, hopSize, ThreadPool::GetShared(), cancel);
+}
+
+bool Spectrogram::Compute(Span<const float> samples, uint64_t frameCount, const FFTProcessor& fft, int hopSize,
+    ThreadPool& pool, const std::atomic<bool>* cancel)
+{
+    m_frameCount = 0;
+    if (hopSize <= 0 || frameCount == 0)
+        return false;
+
+    const int fftSize = fft.GetFFTSize();
+    const int binCount = fft.GetBinCount();
+    const size_t rowStride = (static_cast<size_t>(binCount) + 15) & ~static_cast<size_t>(15);
+
+    if (!m_plan || m_plan->GetFFTSize() != fftSize || m_planBackend != fft.GetBackend())
+    {
+        m_planBackend = fft.GetBackend();
+        m_plan = std::make_unique<FFTBatchPlan>(fftSize, BatchFrames, m_planBackend);
+        if (!m_plan->IsValid())
+        {
+            std::cout << "Failed to create batched FFT plan (" << BatchFrames << " x " << fftSize << ")" << std::endl;
+            m_plan.reset();
+            return false;
+        }
+    }
+
+    // Grows once to the largest block; later blocks reuse the rows
+    m_magnitudes.resize(std::max(m_magnitudes.size(), static_cast<size_t>(frameCount) * rowStride));
+    m_maxMagnitudes.resize(std::max(m_maxMagnitudes.size(), static_cast<size_t>(frameCount)));
+    m_binCount = binCount;
+    m_rowStride = rowStride;
+
+    const FFTBatchPlan& plan = *m_plan;
+    const WindowTable& window = fft.GetWindow();
+    const uint64_t batchCount = (frameCount + BatchFrames - 1) / BatchFrames;
+    std::atomic<bool> cancelled(false);
+
+    // A few batches per range so the per-range buffers are amortised; ranges write
+    // disjoint rows of the matrix
+    pool.ParallelFor(static_cast<size_t>(batchCount), 4, [&](size_t beginBatch, size_t endBatch)
+    {
+        AlignedVector<float> input(static_cast<size_t>(BatchFrames) * fftSize);
+        AlignedVector<float> output(static_cast<size_t>(BatchFrames) * binCount * 2);
+        FFTComplex* bins = reinterpret_cast<FFTComplex*>(output.data());
+        std::vector<float> batchSamples;
+
+        for (size_t batch = beginBatch; batch < endBatch; ++batch)
+        {
+            if (cancel && cancel->load(std::memory_order_relaxed))
+            {
+                cancelled = true;
+                return;
+            }
+
+            const uint64_t firstFrame = static_cast<uint64_t>(batch) * BatchFrames;
+            const int framesInBatch = static_cast<int>(std::min<uint64_t>(BatchFrames, frameCount - firstFrame));
+
+            // The overlapping windows of a batch come from one contiguous span, zero padded
+            // past the end of the block
+            const size_t first = static_cast<size_t>(firstFrame) * hopSize;
+            const size_t sampleCount = static_cast<size_t>(framesInBatch - 1) * hopSize + fftSize;
+            Span<const float> available = samples.subspan(first, sampleCount);
+            const float* windowSource = available.data();
+            if (available.size() < sampleCount)
+            {
+                batchSamples.assign(available.begin(), available.end());
+                batchSamples.resize(sampleCount, 0.0f);
+                windowSource = batchSamples.data();
+            }
+
+            for (int frame = 0; frame < framesInBatch; ++frame)
+            {
+                window.Apply(windowSource + static_cast<size_t>(frame) * hopSize, fftSize, &input[static_cast<size_t>(frame) * fftSize]);
+            }
+            std::fill(input.begin() + static_cast<size_t>(framesInBatch) * fftSize, input.end(), 0.0f);
+
+            plan.Execute(input.data(), bins);
+
+            for (int frame = 0; frame < framesInBatch; ++frame)
+            {
+                size_t row = static_cast<size_t>(firstFrame) + frame;
+                m_maxMagnitudes[row] = FFTProcessor::ComputeMagnitudes(bins + static_cast<size_t>(frame) * binCount,
+                    binCount, &m_magnitudes[row * rowStride]);
+            }
+        }
+    });
+
+    if (cancelled)
+        return false;
+
+    m_frameCount = frameCount;
+    return true;
+}
+
+Span<const float> Spectrogram::GetFrame(uint64_t frame) const
+{
+    if (frame >= m_frameCount)
+        return Span<const float>();
+
+    return Span<const float>(m_magnitudes.data() + static_cast<size_t>(frame) * m_rowStride, static_cast<size_t>(m_binCount));
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "FFTProcessor.h"
+#include "../Utils/AlignedAllocator.h"
+#include "../Utils/Span.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class ThreadPool;
+
+// Magnitude spectrogram of a block of mono samples, for offline analysis. Frame f
+// windows samples [f * hop, f * hop + fftSize) with the FFTProcessor's window (zero
+// padded past the end of the block). Rows are stored back to back in one frames x bins
+// matrix, each padded to a 64-byte multiple so every row starts aligned. AnalysisCache
+// runs whole tracks through it a segment at a time, so the matrix stays small.
+class Spectrogram
+{
+public:
+    Spectrogram();
+    ~Spectrogram();
+
+    // Splits 'frameCount' frames into ranges across 'pool'; each range runs batches of
+    // 'BatchFrames' frames through one shared FFTBatchPlan on 'fft's backend. The plan
+    // and the matrix are kept for the next call with the same size. Returns false on
+    // invalid input or when 'cancel' was raised.
+    bool Compute(Span<const float> samples, uint64_t frameCount, const FFTProcessor& fft, int hopSize,
+        ThreadPool& pool, const std::atomic<bool>* cancel = nullptr);
+    bool Compute(Span<const float> samples, uint64_t frameCount, const FFTProcessor& fft, int hopSize,
+        const std::atomic<bool>* cancel = nullptr);
+
+    uint64_t GetFrameCount() const { return m_frameCount; }
+    int GetBinCount() const { return m_binCount; }
+
+    Span<const float> GetFrame(uint64_t frame) const;
+    float GetMaxMagnitude(uint64_t frame) const { return m_maxMagnitudes[static_cast<size_t>(frame)]; }
+
+    static constexpr int BatchFrames = 16;
+
+private:
+    AlignedVector<float> m_magnitudes; // m_frameCount rows of m_rowStride
+    std::vector<float> m_maxMagnitudes;
+    std::unique_ptr<FFTBatchPlan> m_plan;
+    FFTBackend m_planBackend; // Requested for m_plan, which may have fallen back to the other
+    uint64_t m_frameCount;
+    int m_binCount;
+    size_t m_rowStride; // Floats between rows
+};
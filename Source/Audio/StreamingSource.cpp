@@ -0,0 +1,217 @@
+#include "StreamingSource.h"
+#include "AudioBuffer.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+StreamingSource::StreamingSource(size_t bufferFrames)
+    : m_bufferFrames(std::max(bufferFrames, DecodeChunkFrames * 2))
+    , m_running(false)
+    , m_endOfStream(false)
+    , m_waitInterrupted(false)
+    , m_seekFrame(0)
+    , m_seekRequest(0)
+    , m_seekAck(0)
+    , m_flushIndex(0)
+    , m_seekHandled(0)
+    , m_position(0)
+    , m_underruns(0)
+{
+}
+
+StreamingSource::~StreamingSource()
+{
+    Close();
+}
+
+bool StreamingSource::Open(const PCMView& view)
+{
+    Close();
+
+    if (!view.IsValid())
+        return false;
+
+    m_view = view;
+    m_ring.Resize(m_bufferFrames);
+    m_channelRings.resize(view.GetChannelCount());
+    for (auto& ring : m_channelRings)
+    {
+        if (!ring)
+            ring = std::make_unique<RingBuffer<float>>();
+        ring->Resize(m_bufferFrames);
+    }
+    m_endOfStream = false;
+    m_waitInterrupted = false;
+    m_seekFrame = 0;
+    m_seekRequest = 0;
+    m_seekAck = 0;
+    m_flushIndex = 0;
+    m_seekHandled = 0;
+    m_position = 0;
+    m_underruns = 0;
+
+    m_running = true;
+    m_decoderThread = std::thread(&StreamingSource::DecoderLoop, this);
+
+    std::cout << "Streaming source opened (" << m_ring.GetCapacity() << " frame buffer)" << std::endl;
+    return true;
+}
+
+void StreamingSource::Close()
+{
+    if (m_decoderThread.joinable())
+    {
+        m_running = false;
+        m_wake.notify_one();
+        m_decoderThread.join();
+    }
+
+    m_view.Reset();
+}
+
+size_t StreamingSource::Read(float* output, size_t frameCount, float* const* sourceChannels)
+{
+    size_t framesRead = 0;
+
+    if (ApplyPendingSeek())
+    {
+        // Channel rings first: the decoder only checks m_ring for space, so theirs must
+        // be freed by the time m_ring's is
+        framesRead = std::min(frameCount, m_ring.GetReadAvailable());
+        for (size_t channel = 0; channel < m_channelRings.size(); ++channel)
+        {
+            if (sourceChannels)
+                m_channelRings[channel]->Read(sourceChannels[channel], framesRead);
+            else
+                m_channelRings[channel]->DiscardUntil(m_channelRings[channel]->GetReadIndex() + framesRead);
+        }
+        m_ring.Read(output, framesRead);
+        m_wake.notify_one();
+
+        if (framesRead < frameCount && !m_endOfStream.load(std::memory_order_acquire))
+        {
+            m_underruns.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::fill(output + framesRead, output + frameCount, 0.0f);
+    if (sourceChannels)
+    {
+        for (size_t channel = 0; channel < m_channelRings.size(); ++channel)
+        {
+            std::fill(sourceChannels[channel] + framesRead, sourceChannels[channel] + frameCount, 0.0f);
+        }
+    }
+    m_position += framesRead;
+    return framesRead;
+}
+
+void StreamingSource::Seek(uint64_t frame)
+{
+    if (!IsOpen())
+        return;
+
+    m_seekFrame.store(std::min(frame, GetFrameCount()), std::memory_order_relaxed);
+    m_seekRequest.fetch_add(1, std::memory_order_release);
+    m_position = m_seekFrame.load(std::memory_order_relaxed);
+    m_wake.notify_one();
+}
+
+size_t StreamingSource::WaitForBuffered(size_t frames, std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> lock(m_bufferedMutex);
+    m_bufferedChanged.wait_until(lock, deadline, [this, frames]
+        {
+            return m_waitInterrupted || IsEndOfStream() || GetBufferedFrames() >= frames;
+        });
+    return GetBufferedFrames();
+}
+
+void StreamingSource::InterruptWait()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_bufferedMutex);
+        m_waitInterrupted = true;
+    }
+    m_bufferedChanged.notify_all();
+}
+
+bool StreamingSource::IsFinished() const
+{
+    return m_seekHandled == m_seekRequest.load(std::memory_order_relaxed) &&
+        m_endOfStream.load(std::memory_order_acquire) &&
+        m_ring.GetReadAvailable() == 0;
+}
+
+bool StreamingSource::ApplyPendingSeek()
+{
+    uint32_t request = m_seekRequest.load(std::memory_order_relaxed);
+    if (m_seekHandled == request)
+        return true;
+
+    // Wait until the decoder has seen the seek, then drop everything written before it
+    if (m_seekAck.load(std::memory_order_acquire) != request)
+        return false;
+
+    const size_t flushIndex = m_flushIndex.load(std::memory_order_relaxed);
+    for (auto& ring : m_channelRings)
+    {
+        ring->DiscardUntil(flushIndex);
+    }
+    m_ring.DiscardUntil(flushIndex);
+    m_seekHandled = request;
+    return true;
+}
+
+void StreamingSource::DecoderLoop()
+{
+    std::vector<float> chunk(DecodeChunkFrames);
+    AudioBuffer planarChunk;
+    uint64_t decodeFrame = 0;
+    uint32_t seekHandled = 0;
+    const uint64_t frameCount = m_view.GetFrameCount();
+
+    while (m_running.load(std::memory_order_relaxed))
+    {
+        uint32_t request = m_seekRequest.load(std::memory_order_acquire);
+        if (request != seekHandled)
+        {
+            decodeFrame = m_seekFrame.load(std::memory_order_relaxed);
+            m_endOfStream.store(false, std::memory_order_relaxed);
+            m_flushIndex.store(m_ring.GetWriteIndex(), std::memory_order_relaxed);
+            m_seekAck.store(request, std::memory_order_release);
+            seekHandled = request;
+        }
+
+        if (!m_endOfStream.load(std::memory_order_relaxed) && m_ring.GetWriteAvailable() >= DecodeChunkFrames)
+        {
+            // The source channels are needed anyway, so the view is derived from them
+            planarChunk.Allocate(m_view.GetChannelCount(), DecodeChunkFrames, m_view.GetSampleRate());
+            size_t frames = m_view.ReadPlanar(decodeFrame, DecodeChunkFrames, planarChunk.GetChannels());
+            planarChunk.SetFrameCount(frames);
+            planarChunk.GetView(ChannelView::Mono).Read(0, frames, chunk.data());
+
+            for (size_t channel = 0; channel < m_channelRings.size(); ++channel)
+            {
+                m_channelRings[channel]->Write(planarChunk.GetChannel(static_cast<int>(channel)), frames);
+            }
+            m_ring.Write(chunk.data(), frames);
+            decodeFrame += frames;
+
+            if (frames == 0 || decodeFrame >= frameCount)
+            {
+                m_endOfStream.store(true, std::memory_order_release);
+            }
+
+            // Taking the lock orders this against a waiter's predicate check, so the wakeup is not lost
+            {
+                std::lock_guard<std::mutex> lock(m_bufferedMutex);
+            }
+            m_bufferedChanged.notify_all();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wake.wait_for(lock, std::chrono::milliseconds(5));
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "AudioLoader.h"
+#include "../Utils/RingBuffer.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Streams a PCMView as mono float frames. A background decoder keeps a fixed-size
+// ring buffer filled ahead of the read cursor, so memory stays bounded regardless of
+// the track length. The source channels are streamed alongside in rings of their own,
+// so consumers that need them (metering) never decode on their thread.
+// Read() and Seek() must be called from a single consumer thread.
+class StreamingSource
+{
+public:
+    StreamingSource(size_t bufferFrames = 131072);
+    ~StreamingSource();
+
+    bool Open(const PCMView& view);
+    void Close();
+
+    // Reads up to frameCount frames; any shortfall is zero-filled. Returns frames read.
+    // If sourceChannels is given, GetChannelCount() planar buffers of frameCount each
+    // receive the same frames of the source channels.
+    size_t Read(float* output, size_t frameCount, float* const* sourceChannels = nullptr);
+    void Seek(uint64_t frame);
+
+    bool IsOpen() const { return m_view.IsValid(); }
+    bool IsFinished() const;
+
+    // True once the decoder has stopped: at the end of the data, or early when a read
+    // returned nothing. Buffered frames may still be waiting to be read.
+    bool IsEndOfStream() const { return m_endOfStream.load(std::memory_order_acquire); }
+
+    uint64_t GetPosition() const { return m_position; }
+    uint64_t GetFrameCount() const { return m_view.GetFrameCount(); }
+    int GetSampleRate() const { return m_view.GetSampleRate(); }
+    int GetChannelCount() const { return m_view.GetChannelCount(); }
+    float GetDuration() const { return m_view.GetDuration(); }
+    const PCMView& GetView() const { return m_view; }
+
+    uint64_t GetUnderrunCount() const { return m_underruns.load(std::memory_order_relaxed); }
+    size_t GetBufferedFrames() const { return m_ring.GetReadAvailable(); }
+
+    // Blocks until at least 'frames' frames are buffered, the decoder stops, 'deadline'
+    // passes or InterruptWait() is called; returns the frames buffered. For the thread
+    // priming a new stream, before playback starts reading.
+    size_t WaitForBuffered(size_t frames, std::chrono::steady_clock::time_point deadline);
+    void InterruptWait(); // Wakes WaitForBuffered now and makes later calls return at once
+
+private:
+    void DecoderLoop();
+    bool ApplyPendingSeek();
+
+    static constexpr size_t DecodeChunkFrames = 4096;
+
+    PCMView m_view;
+    RingBuffer<float> m_ring;
+    // One per source channel, written before m_ring and read before it, so their
+    // indices match m_ring's whenever the consumer looks
+    std::vector<std::unique_ptr<RingBuffer<float>>> m_channelRings;
+    size_t m_bufferFrames;
+
+    std::thread m_decoderThread;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wake;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_endOfStream;
+
+    // Signalled by the decoder after every chunk and when it stops
+    std::mutex m_bufferedMutex;
+    std::condition_variable m_bufferedChanged;
+    bool m_waitInterrupted;
+
+    // Seek handshake: the consumer bumps m_seekRequest, the decoder records where the
+    // stale data ends in m_flushIndex and acknowledges through m_seekAck
+    std::atomic<uint64_t> m_seekFrame;
+    std::atomic<uint32_t> m_seekRequest;
+    std::atomic<uint32_t> m_seekAck;
+    std::atomic<size_t> m_flushIndex;
+    uint32_t m_seekHandled;
+
+    uint64_t m_position;
+    std::atomic<uint64_t> m_underruns;
+};
@@ -0,0 +1,269 @@
+#include "TrackLoader.h"
+#include "StreamingSource.h"
+#include "AnalysisCache.h"
+#include "../Utils/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+TrackLoadJob::TrackLoadJob(const std::string& filename)
+    : m_filename(filename)
+    , m_state(TrackLoadState::Pending)
+    , m_cancelRequested(false)
+    , m_bytesParsed(0)
+    , m_totalBytes(0)
+    , m_samplesConverted(0)
+    , m_targetSamples(0)
+    , m_contentHash(0)
+    , m_hashing(false)
+    , m_bufferingStream(nullptr)
+{
+}
+
+TrackLoadJob::~TrackLoadJob()
+{
+}
+
+void TrackLoadJob::Cancel()
+{
+    m_cancelRequested.store(true, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_bufferingStream)
+        m_bufferingStream->InterruptWait();
+}
+
+bool TrackLoadJob::IsDone() const
+{
+    TrackLoadState state = GetState();
+    return state == TrackLoadState::Ready || state == TrackLoadState::Failed || state == TrackLoadState::Cancelled;
+}
+
+float TrackLoadJob::GetProgress() const
+{
+    if (GetState() == TrackLoadState::Ready)
+        return 1.0f;
+
+    uint64_t targetSamples = GetTargetSamples();
+    float buffered = targetSamples > 0 ? std::min(1.0f, static_cast<float>(GetSamplesConverted()) / targetSamples) : 0.0f;
+
+    // With hashing on, parsing (the headers and the hashed data chunk) counts for the first half
+    if (m_hashing.load(std::memory_order_relaxed))
+    {
+        uint64_t totalBytes = GetTotalBytes();
+        float parsed = totalBytes > 0 ? std::min(1.0f, static_cast<float>(GetBytesParsed()) / totalBytes) : 0.0f;
+        return 0.5f * parsed + 0.5f * buffered;
+    }
+
+    return buffered;
+}
+
+void TrackLoadJob::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this] { return IsDone(); });
+}
+
+std::unique_ptr<StreamingSource> TrackLoadJob::TakeStream()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (GetState() != TrackLoadState::Ready)
+        return nullptr;
+
+    return std::move(m_stream);
+}
+
+void TrackLoadJob::Finish(TrackLoadState state)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_state.store(state, std::memory_order_release);
+    }
+    m_done.notify_all();
+}
+
+TrackLoader::TrackLoader(size_t prebufferFrames)
+    : m_prebufferFrames(prebufferFrames), m_contentHashing(false)
+{
+}
+
+TrackLoader::~TrackLoader()
+{
+    std::vector<std::shared_ptr<TrackLoadJob>> jobs;
+    {
+        std::lock_guard<std::mutex> lock(m_jobsMutex);
+        for (auto& weakJob : m_jobs)
+        {
+            if (auto job = weakJob.lock())
+                jobs.push_back(job);
+        }
+    }
+
+    // Run() uses m_loader, so no job may outlive the loader
+    for (auto& job : jobs)
+    {
+        job->Cancel();
+        job->Wait();
+    }
+}
+
+std::shared_ptr<TrackLoadJob> TrackLoader::Load(const std::string& filename)
+{
+    auto job = std::make_shared<TrackLoadJob>(filename);
+
+    {
+        std::lock_guard<std::mutex> lock(m_jobsMutex);
+        m_jobs.erase(std::remove_if(m_jobs.begin(), m_jobs.end(),
+            [](const std::weak_ptr<TrackLoadJob>& weakJob)
+            {
+                auto job = weakJob.lock();
+                return !job || job->IsDone();
+            }), m_jobs.end());
+        m_jobs.push_back(job);
+    }
+
+    ThreadPool::GetShared().Submit([this, job] { Run(job); });
+    return job;
+}
+
+void TrackLoader::Run(const std::shared_ptr<TrackLoadJob>& job)
+{
+    auto loadStart = std::chrono::steady_clock::now();
+
+    if (job->IsCancelRequested())
+    {
+        job->Finish(TrackLoadState::Cancelled);
+        return;
+    }
+
+    job->m_state.store(TrackLoadState::Parsing, std::memory_order_release);
+
+    PCMView view;
+    if (!m_loader.OpenWAVFile(job->m_filename, view))
+    {
+        job->Finish(TrackLoadState::Failed);
+        return;
+    }
+
+    const uint64_t channels = view.GetChannelCount();
+    const uint64_t prebufferFrames = std::min<uint64_t>(m_prebufferFrames, view.GetFrameCount());
+
+    job->m_totalBytes.store(view.GetDataOffset() + view.GetDataSize(), std::memory_order_relaxed);
+    job->m_bytesParsed.store(view.GetDataOffset(), std::memory_order_relaxed);
+    job->m_targetSamples.store(prebufferFrames * channels, std::memory_order_relaxed);
+
+    // Ring sized so the prebuffer always fits with room for the decoder to keep going.
+    // The decoder starts on its own thread right away, so it fills the ring while the
+    // data chunk is hashed.
+    auto stream = std::make_unique<StreamingSource>(std::max<size_t>(131072, m_prebufferFrames * 2));
+    if (!stream->Open(view))
+    {
+        job->Finish(TrackLoadState::Failed);
+        return;
+    }
+
+    if (m_contentHashing)
+    {
+        job->m_hashing.store(true, std::memory_order_relaxed);
+
+        auto hashStart = std::chrono::steady_clock::now();
+        uint64_t hash = AnalysisCache::ComputeContentHash(view, &job->m_bytesParsed, &job->m_cancelRequested);
+        std::chrono::duration<double> hashTime = std::chrono::steady_clock::now() - hashStart;
+
+        job->m_contentHash.store(hash, std::memory_order_release);
+        if (hash != 0)
+        {
+            std::cout << "Content hash computed in " << hashTime.count() * 1000.0 << " ms" << std::endl;
+        }
+    }
+
+    if (job->IsCancelRequested())
+    {
+        stream->Close();
+        job->Finish(TrackLoadState::Cancelled);
+        return;
+    }
+
+    // Wait for the decoder to get ahead of playback
+    job->m_state.store(TrackLoadState::Buffering, std::memory_order_release);
+
+    TrackLoadState state = WaitForPrebuffer(*job, *stream, prebufferFrames);
+    if (state != TrackLoadState::Buffering)
+    {
+        stream->Close();
+        job->Finish(state);
+        return;
+    }
+
+    std::chrono::duration<double> loadTime = std::chrono::steady_clock::now() - loadStart;
+    std::cout << "Track ready in " << loadTime.count() * 1000.0 << " ms (" << stream->GetBufferedFrames()
+        << " frames buffered)" << std::endl;
+
+    {
+        std::lock_guard<std::mutex> lock(job->m_mutex);
+        job->m_stream = std::move(stream);
+    }
+    job->Finish(TrackLoadState::Ready);
+}
+
+TrackLoadState TrackLoader::WaitForPrebuffer(TrackLoadJob& job, StreamingSource& stream, uint64_t prebufferFrames)
+{
+    const PCMView& view = stream.GetView();
+    const uint64_t blockAlign = view.GetFormat().blockAlign;
+    const uint64_t channels = view.GetChannelCount();
+
+    // Cancel() interrupts the wait through the stream while it is registered here
+    {
+        std::lock_guard<std::mutex> lock(job.m_mutex);
+        job.m_bufferingStream = &stream;
+    }
+
+    TrackLoadState state = TrackLoadState::Buffering;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(PrebufferTimeoutMs);
+    for (;;)
+    {
+        if (job.IsCancelRequested())
+        {
+            state = TrackLoadState::Cancelled;
+            break;
+        }
+
+        // Checked before the count, so a stopped decoder's count is final
+        bool endOfStream = stream.IsEndOfStream();
+        uint64_t buffered = stream.GetBufferedFrames();
+        job.m_samplesConverted.store(buffered * channels, std::memory_order_relaxed);
+        if (!m_contentHashing)
+        {
+            job.m_bytesParsed.store(view.GetDataOffset() + buffered * blockAlign, std::memory_order_relaxed);
+        }
+
+        if (buffered >= prebufferFrames)
+            break;
+
+        // The decoder stopped short: a read error, or less data than the header promised.
+        // Whatever it got is still playable.
+        if (endOfStream)
+        {
+            std::cout << "Decoder stopped after " << buffered << " of " << prebufferFrames << " prebuffer frames" << std::endl;
+            if (buffered == 0)
+                state = TrackLoadState::Failed;
+            break;
+        }
+
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            std::cout << "Timed out buffering " << job.m_filename << " (" << buffered << " of " << prebufferFrames << " frames)" << std::endl;
+            state = TrackLoadState::Failed;
+            break;
+        }
+
+        // Sleeps until the decoder writes its next chunk (progress), stops or is cancelled
+        stream.WaitForBuffered(static_cast<size_t>(buffered) + 1, deadline);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(job.m_mutex);
+        job.m_bufferingStream = nullptr;
+    }
+    return state;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "AudioLoader.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class StreamingSource;
+
+enum class TrackLoadState
+{
+    Pending,
+    Parsing,   // Reading the RIFF headers and, with hashing on, hashing the data chunk
+    Buffering, // Stream is open, decoder is filling its ring ahead of playback
+    Ready,
+    Failed,
+    Cancelled
+};
+
+// Handle to one background load. Progress counters are updated by the loading thread
+// and can be polled from any thread; the finished stream is handed over once through
+// TakeStream().
+class TrackLoadJob
+{
+public:
+    explicit TrackLoadJob(const std::string& filename);
+    ~TrackLoadJob();
+
+    const std::string& GetFilename() const { return m_filename; }
+    TrackLoadState GetState() const { return m_state.load(std::memory_order_acquire); }
+    bool IsDone() const;
+
+    // Stops the job at its next check, or at once while it waits on the decoder; a job
+    // that already finished is left as it is
+    void Cancel();
+    bool IsCancelRequested() const { return m_cancelRequested.load(std::memory_order_relaxed); }
+
+    uint64_t GetBytesParsed() const { return m_bytesParsed.load(std::memory_order_relaxed); }
+    uint64_t GetTotalBytes() const { return m_totalBytes.load(std::memory_order_relaxed); }
+    uint64_t GetSamplesConverted() const { return m_samplesConverted.load(std::memory_order_relaxed); }
+    uint64_t GetTargetSamples() const { return m_targetSamples.load(std::memory_order_relaxed); }
+    float GetProgress() const; // 0..1 towards Ready
+
+    // Content hash of the PCM data for AnalysisCache lookups, 0 when hashing is off
+    uint64_t GetContentHash() const { return m_contentHash.load(std::memory_order_acquire); }
+
+    // Blocks until the job has left the Pending/Parsing/Buffering states
+    void Wait();
+
+    // Moves the opened stream out; nullptr unless the state is Ready
+    std::unique_ptr<StreamingSource> TakeStream();
+
+private:
+    friend class TrackLoader;
+
+    void Finish(TrackLoadState state);
+
+    std::string m_filename;
+    std::atomic<TrackLoadState> m_state;
+    std::atomic<bool> m_cancelRequested;
+
+    std::atomic<uint64_t> m_bytesParsed;
+    std::atomic<uint64_t> m_totalBytes;
+    std::atomic<uint64_t> m_samplesConverted;
+    std::atomic<uint64_t> m_targetSamples;
+    std::atomic<uint64_t> m_contentHash;
+    std::atomic<bool> m_hashing;
+
+    std::unique_ptr<StreamingSource> m_stream;
+    StreamingSource* m_bufferingStream; // Set while the loader waits for the prebuffer
+    std::mutex m_mutex;
+    std::condition_variable m_done;
+};
+
+// Opens tracks off the render thread. Each load parses the file and primes a new
+// StreamingSource until enough audio is buffered to start without an underrun; the
+// caller polls the job and swaps the stream in when it reports Ready, so the current
+// track keeps playing in the meantime.
+class TrackLoader
+{
+public:
+    TrackLoader(size_t prebufferFrames = 65536);
+    ~TrackLoader(); // Cancels and waits for every outstanding job
+
+    std::shared_ptr<TrackLoadJob> Load(const std::string& filename);
+
+    // Hash the PCM data of every load so the caller can look up cached analysis
+    void SetContentHashing(bool enabled) { m_contentHashing = enabled; }
+
+private:
+    void Run(const std::shared_ptr<TrackLoadJob>& job);
+
+    // Sleeps until the decoder has buffered the prebuffer; the resulting state, or
+    // Buffering to go on to Ready
+    TrackLoadState WaitForPrebuffer(TrackLoadJob& job, StreamingSource& stream, uint64_t prebufferFrames);
+
+    // A load fails if the decoder has not buffered enough by then (e.g. a stalled drive)
+    static constexpr int PrebufferTimeoutMs = 10000;
+
+    AudioLoader m_loader;
+    size_t m_prebufferFrames;
+    bool m_contentHashing;
+
+    std::mutex m_jobsMutex;
+    std::vector<std::weak_ptr<TrackLoadJob>> m_jobs;
+};
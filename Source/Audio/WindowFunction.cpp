@@ -0,0 +1,248 @@
+#include "WindowFunction.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <emmintrin.h>
+
+namespace
+{
+    constexpr double Pi = 3.14159265358979323846;
+
+    // a0 - a1 cos(t) + a2 cos(2t) - a3 cos(3t) + a4 cos(4t)
+    struct CosineSum
+    {
+        double a[5];
+    };
+
+    constexpr CosineSum HannCoefficients = { { 0.5, 0.5, 0.0, 0.0, 0.0 } };
+    constexpr CosineSum HammingCoefficients = { { 0.54, 0.46, 0.0, 0.0, 0.0 } };
+    constexpr CosineSum BlackmanHarrisCoefficients = { { 0.35875, 0.48829, 0.14128, 0.01168, 0.0 } };
+    constexpr CosineSum FlatTopCoefficients = { { 0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368 } };
+
+    // Taylor series, accurate to double precision for the single small angle each table needs
+    constexpr void SinCos(double x, double& sine, double& cosine)
+    {
+        double sinTerm = x, cosTerm = 1.0;
+        sine = x;
+        cosine = 1.0;
+        for (int k = 1; k < 12; ++k)
+        {
+            cosTerm *= -x * x / ((2.0 * k - 1.0) * (2.0 * k));
+            sinTerm *= -x * x / ((2.0 * k) * (2.0 * k + 1.0));
+            cosine += cosTerm;
+            sine += sinTerm;
+        }
+    }
+
+    // constexpr so the same code builds the compile-time tables and any other size at
+    // runtime. cos(n t) comes from rotating by t each step (error grows linearly, far
+    // below float precision at 64k points), cos(2t)..cos(4t) from Chebyshev polynomials.
+    constexpr void FillCosineSum(float* table, int size, const CosineSum& sum)
+    {
+        double stepSin = 0.0, stepCos = 1.0;
+        SinCos(2.0 * Pi / (size - 1), stepSin, stepCos);
+
+        double c = 1.0, s = 0.0;
+        for (int n = 0; n < size; ++n)
+        {
+            double c2 = 2.0 * c * c - 1.0;
+            double c3 = (4.0 * c * c - 3.0) * c;
+            double c4 = 8.0 * c * c * (c * c - 1.0) + 1.0;
+            table[n] = static_cast<float>(sum.a[0] - sum.a[1] * c + sum.a[2] * c2 - sum.a[3] * c3 + sum.a[4] * c4);
+
+            double nextC = c * stepCos - s * stepSin;
+            s = s * stepCos + c * stepSin;
+            c = nextC;
+        }
+    }
+
+    template <int Size>
+    constexpr std::array<float, Size> MakeCosineSumTable(const CosineSum& sum)
+    {
+        std::array<float, Size> table = {};
+        FillCosineSum(table.data(), Size, sum);
+        return table;
+    }
+
+    // Compile-time tables for the analysis sizes in use
+    alignas(64) constexpr std::array<float, 1024> Hann1024 = MakeCosineSumTable<1024>(HannCoefficients);
+    alignas(64) constexpr std::array<float, 2048> Hann2048 = MakeCosineSumTable<2048>(HannCoefficients);
+    alignas(64) constexpr std::array<float, 4096> Hann4096 = MakeCosineSumTable<4096>(HannCoefficients);
+    alignas(64) constexpr std::array<float, 1024> Hamming1024 = MakeCosineSumTable<1024>(HammingCoefficients);
+    alignas(64) constexpr std::array<float, 2048> Hamming2048 = MakeCosineSumTable<2048>(HammingCoefficients);
+    alignas(64) constexpr std::array<float, 4096> Hamming4096 = MakeCosineSumTable<4096>(HammingCoefficients);
+    alignas(64) constexpr std::array<float, 1024> BlackmanHarris1024 = MakeCosineSumTable<1024>(BlackmanHarrisCoefficients);
+    alignas(64) constexpr std::array<float, 2048> BlackmanHarris2048 = MakeCosineSumTable<2048>(BlackmanHarrisCoefficients);
+    alignas(64) constexpr std::array<float, 4096> BlackmanHarris4096 = MakeCosineSumTable<4096>(BlackmanHarrisCoefficients);
+    alignas(64) constexpr std::array<float, 1024> FlatTop1024 = MakeCosineSumTable<1024>(FlatTopCoefficients);
+    alignas(64) constexpr std::array<float, 2048> FlatTop2048 = MakeCosineSumTable<2048>(FlatTopCoefficients);
+    alignas(64) constexpr std::array<float, 4096> FlatTop4096 = MakeCosineSumTable<4096>(FlatTopCoefficients);
+
+    const float* FindPrecomputedTable(WindowType type, int size)
+    {
+        switch (type)
+        {
+        case WindowType::Hann:
+            return size == 1024 ? Hann1024.data() : size == 2048 ? Hann2048.data() : size == 4096 ? Hann4096.data() : nullptr;
+        case WindowType::Hamming:
+            return size == 1024 ? Hamming1024.data() : size == 2048 ? Hamming2048.data() : size == 4096 ? Hamming4096.data() : nullptr;
+        case WindowType::BlackmanHarris:
+            return size == 1024 ? BlackmanHarris1024.data() : size == 2048 ? BlackmanHarris2048.data() : size == 4096 ? BlackmanHarris4096.data() : nullptr;
+        case WindowType::FlatTop:
+            return size == 1024 ? FlatTop1024.data() : size == 2048 ? FlatTop2048.data() : size == 4096 ? FlatTop4096.data() : nullptr;
+        default:
+            return nullptr;
+        }
+    }
+
+    // Zeroth-order modified Bessel function of the first kind
+    double BesselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 200 && term > sum * 1e-16; ++k)
+        {
+            double factor = x / (2.0 * k);
+            term *= factor * factor;
+            sum += term;
+        }
+        return sum;
+    }
+
+    void FillWindow(float* table, int size, WindowType type, double parameter)
+    {
+        if (size == 1)
+        {
+            table[0] = 1.0f;
+            return;
+        }
+
+        const double half = (size - 1) * 0.5;
+        switch (type)
+        {
+        case WindowType::Hann:
+            FillCosineSum(table, size, HannCoefficients);
+            break;
+        case WindowType::Hamming:
+            FillCosineSum(table, size, HammingCoefficients);
+            break;
+        case WindowType::BlackmanHarris:
+            FillCosineSum(table, size, BlackmanHarrisCoefficients);
+            break;
+        case WindowType::FlatTop:
+            FillCosineSum(table, size, FlatTopCoefficients);
+            break;
+        case WindowType::Kaiser:
+        {
+            const double scale = 1.0 / BesselI0(parameter);
+            for (int n = 0; n < size; ++n)
+            {
+                double x = (n - half) / half;
+                table[n] = static_cast<float>(BesselI0(parameter * sqrt(std::max(0.0, 1.0 - x * x))) * scale);
+            }
+            break;
+        }
+        case WindowType::Gaussian:
+            for (int n = 0; n < size; ++n)
+            {
+                double x = (n - half) / (parameter * half);
+                table[n] = static_cast<float>(exp(-0.5 * x * x));
+            }
+            break;
+        }
+    }
+
+    void MultiplySSE2(const float* input, const float* window, size_t count, float* output)
+    {
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm_storeu_ps(output + i, _mm_mul_ps(_mm_loadu_ps(input + i), _mm_load_ps(window + i)));
+            _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_loadu_ps(input + i + 4), _mm_load_ps(window + i + 4)));
+        }
+        for (; i < count; ++i)
+        {
+            output[i] = input[i] * window[i];
+        }
+    }
+
+    std::mutex s_registryMutex;
+    std::map<std::tuple<WindowType, int, float>, std::shared_ptr<const WindowTable>> s_registry;
+}
+
+WindowTable::WindowTable(WindowType type, int size, float parameter)
+    : m_type(type), m_size(size), m_parameter(parameter), m_data(nullptr)
+{
+    m_storage.resize(static_cast<size_t>(size));
+    FillWindow(m_storage.data(), size, type, parameter);
+    m_data = m_storage.data();
+}
+
+WindowTable::WindowTable(WindowType type, int size, const float* precomputed)
+    : m_type(type), m_size(size), m_parameter(0.0f), m_data(precomputed)
+{
+}
+
+void WindowTable::Apply(const float* input, size_t count, float* output) const
+{
+    count = std::min(count, static_cast<size_t>(m_size));
+    MultiplySSE2(input, m_data, count, output);
+    memset(output + count, 0, (m_size - count) * sizeof(float));
+}
+
+void WindowTable::ApplyInPlace(float* data, size_t count) const
+{
+    MultiplySSE2(data, m_data, std::min(count, static_cast<size_t>(m_size)), data);
+}
+
+namespace WindowFunction
+{
+    std::shared_ptr<const WindowTable> Get(WindowType type, int size, float parameter)
+    {
+        if (size <= 0)
+            return nullptr;
+
+        const float defaultParameter = GetDefaultParameter(type);
+        parameter = defaultParameter == 0.0f ? 0.0f : parameter > 0.0f ? parameter : defaultParameter;
+
+        std::lock_guard<std::mutex> lock(s_registryMutex);
+        std::shared_ptr<const WindowTable>& table = s_registry[std::make_tuple(type, size, parameter)];
+        if (!table)
+        {
+            const float* precomputed = FindPrecomputedTable(type, size);
+            table = precomputed ? std::make_shared<const WindowTable>(type, size, precomputed)
+                : std::make_shared<const WindowTable>(type, size, parameter);
+        }
+        return table;
+    }
+
+    float GetDefaultParameter(WindowType type)
+    {
+        switch (type)
+        {
+        case WindowType::Kaiser:
+            return 8.6f;
+        case WindowType::Gaussian:
+            return 0.4f;
+        default:
+            return 0.0f;
+        }
+    }
+
+    const char* GetName(WindowType type)
+    {
+        switch (type)
+        {
+        case WindowType::Hann: return "Hann";
+        case WindowType::Hamming: return "Hamming";
+        case WindowType::BlackmanHarris: return "Blackman-Harris";
+        case WindowType::Kaiser: return "Kaiser";
+        case WindowType::FlatTop: return "Flat-top";
+        case WindowType::Gaussian: return "Gaussian";
+        default: return "Unknown";
+        }
+    }
+}
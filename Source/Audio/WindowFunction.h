@@ -0,0 +1,58 @@
+#pragma once
+#include "../Utils/AlignedAllocator.h"
+#include <cstddef>
+#include <memory>
+
+enum class WindowType
+{
+    Hann,
+    Hamming,
+    BlackmanHarris, // 4-term, -92 dB sidelobes
+    Kaiser,         // Parameter: beta (default 8.6)
+    FlatTop,        // For amplitude accuracy; very wide main lobe
+    Gaussian        // Parameter: sigma relative to half the window (default 0.4)
+};
+
+// Symmetric window coefficients for one (type, size, parameter). Tables never change
+// once built; WindowFunction::Get hands the same table to every processor that asks.
+class WindowTable
+{
+public:
+    WindowTable(WindowType type, int size, float parameter);
+    WindowTable(WindowType type, int size, const float* precomputed); // Compile-time table, not copied
+
+    WindowTable(const WindowTable&) = delete;
+    WindowTable& operator=(const WindowTable&) = delete;
+
+    WindowType GetType() const { return m_type; }
+    int GetSize() const { return m_size; }
+    float GetParameter() const { return m_parameter; }
+    const float* GetData() const { return m_data; }
+    float operator[](size_t index) const { return m_data[index]; }
+
+    // Windows the first min(count, GetSize()) samples of 'input' into 'output' and zero
+    // pads the rest of 'output' (GetSize() floats) in the same SSE2 pass
+    void Apply(const float* input, size_t count, float* output) const;
+
+    // Windows min(count, GetSize()) samples in place
+    void ApplyInPlace(float* data, size_t count) const;
+
+private:
+    WindowType m_type;
+    int m_size;
+    float m_parameter;
+    const float* m_data;
+    AlignedVector<float> m_storage; // Empty for compile-time tables
+};
+
+namespace WindowFunction
+{
+    // Shared table for (type, size, parameter), built on first use; thread safe.
+    // 'parameter' <= 0 picks the type's default and is ignored by types without one.
+    // Hann, Hamming, Blackman-Harris and flat-top at 1024, 2048 and 4096 points come
+    // from tables generated at compile time.
+    std::shared_ptr<const WindowTable> Get(WindowType type, int size, float parameter = 0.0f);
+
+    float GetDefaultParameter(WindowType type); // 0 for types without a parameter
+    const char* GetName(WindowType type);
+}
@@ -9,13 +9,20 @@ const float GUIManager::KEY_DEBOUNCE_TIME = 0.3f;
 GUIManager::GUIManager()
     : m_hwnd(nullptr)
     , m_shouldLoadFile(false)
+    , m_shouldLoadNextTrack(false)
     , m_shouldTogglePlayback(false)
+    , m_shouldToggleLowLatency(false)
+    , m_shouldToggleMultiResolution(false)
+    , m_shouldCycleBandLayout(false)
+    , m_shouldToggleBandWeighting(false)
+    , m_shouldCycleWindow(false)
     , m_shouldExit(false)
     , m_isPlaying(false)
     , m_duration(0.0f)
     , m_currentTime(0.0f)
     , m_fftSize(4096)
     , m_maxFrequency(22050.0f)
+    , m_fftLabel("FFT Size")
     , m_time(0.0f)
     , m_showHelp(true)
     , m_lastKeyTime(0.0f)
@@ -108,7 +115,7 @@ void GUIManager::Render(HDC hdc)
 
     // FFT 정보
     std::ostringstream fftStream;
-    fftStream << "FFT Size: " << m_fftSize << " | Max Freq: " << (int)m_maxFrequency << " Hz";
+    fftStream << m_fftLabel << ": " << m_fftSize << " | Max Freq: " << (int)m_maxFrequency << " Hz";
     DrawText(hdc, fftStream.str(), 20, y, RGB(180, 180, 180));
     y += lineHeight * 2;
 
@@ -119,8 +126,20 @@ void GUIManager::Render(HDC hdc)
         y += lineHeight;
         DrawText(hdc, "O - Load WAV file", 20, y, RGB(200, 200, 200));
         y += lineHeight;
+        DrawText(hdc, "N - Next WAV in the same folder", 20, y, RGB(200, 200, 200));
+        y += lineHeight;
         DrawText(hdc, "SPACE - Play/Pause", 20, y, RGB(200, 200, 200));
         y += lineHeight;
+        DrawText(hdc, "L - Low-latency analysis", 20, y, RGB(200, 200, 200));
+        y += lineHeight;
+        DrawText(hdc, "M - Multi-resolution analysis", 20, y, RGB(200, 200, 200));
+        y += lineHeight;
+        DrawText(hdc, "B - Cycle band layout", 20, y, RGB(200, 200, 200));
+        y += lineHeight;
+        DrawText(hdc, "T - Triangular/rectangular band weighting", 20, y, RGB(200, 200, 200));
+        y += lineHeight;
+        DrawText(hdc, "W - Cycle STFT window", 20, y, RGB(200, 200, 200));
+        y += lineHeight;
         DrawText(hdc, "H - Toggle help", 20, y, RGB(200, 200, 200));
         y += lineHeight;
         DrawText(hdc, "ESC - Exit", 20, y, RGB(200, 200, 200));
@@ -133,6 +152,7 @@ void GUIManager::Render(HDC hdc)
             if (m_lastKey == VK_SPACE) keyInfo += "SPACE";
             else if (m_lastKey == 'O' || m_lastKey == 'o') keyInfo += "O";
             else if (m_lastKey == 'H' || m_lastKey == 'h') keyInfo += "H";
+            else if (m_lastKey == 'L' || m_lastKey == 'l') keyInfo += "L";
             else if (m_lastKey == VK_ESCAPE) keyInfo += "ESC";
             else keyInfo += std::to_string(m_lastKey);
 
@@ -159,10 +179,40 @@ void GUIManager::OnKeyDown(WPARAM key)
         std::cout << "O key pressed - Load file" << std::endl;
         m_shouldLoadFile = true;
         break;
+    case 'N':
+    case 'n':
+        std::cout << "N key pressed - Next track in folder" << std::endl;
+        m_shouldLoadNextTrack = true;
+        break;
     case VK_SPACE:
         std::cout << "SPACE key pressed - Toggle playback" << std::endl;
         m_shouldTogglePlayback = true;
         break;
+    case 'L':
+    case 'l':
+        std::cout << "L key pressed - Toggle low-latency analysis" << std::endl;
+        m_shouldToggleLowLatency = true;
+        break;
+    case 'M':
+    case 'm':
+        std::cout << "M key pressed - Toggle multi-resolution analysis" << std::endl;
+        m_shouldToggleMultiResolution = true;
+        break;
+    case 'B':
+    case 'b':
+        std::cout << "B key pressed - Cycle band layout" << std::endl;
+        m_shouldCycleBandLayout = true;
+        break;
+    case 'T':
+    case 't':
+        std::cout << "T key pressed - Toggle band weighting" << std::endl;
+        m_shouldToggleBandWeighting = true;
+        break;
+    case 'W':
+    case 'w':
+        std::cout << "W key pressed - Cycle STFT window" << std::endl;
+        m_shouldCycleWindow = true;
+        break;
     case 'H':
     case 'h':
         std::cout << "H key pressed - Toggle help" << std::endl;
@@ -205,15 +255,22 @@ void GUIManager::SetAudioInfo(const std::string& filename, bool isPlaying, float
     m_currentTime = currentTime;
 }
 
-void GUIManager::SetFFTInfo(int fftSize, float maxFrequency)
+void GUIManager::SetFFTInfo(int fftSize, float maxFrequency, const std::string& label)
 {
     m_fftSize = fftSize;
     m_maxFrequency = maxFrequency;
+    m_fftLabel = label;
 }
 
 void GUIManager::ResetFlags()
 {
     m_shouldLoadFile = false;
+    m_shouldLoadNextTrack = false;
     m_shouldTogglePlayback = false;
+    m_shouldToggleLowLatency = false;
+    m_shouldToggleMultiResolution = false;
+    m_shouldCycleBandLayout = false;
+    m_shouldToggleBandWeighting = false;
+    m_shouldCycleWindow = false;
     m_shouldExit = false;
 }
\ No newline at end of file
@@ -16,12 +16,18 @@ public:
 
     // GUI  ȯ
     bool ShouldLoadFile() const { return m_shouldLoadFile; }
+    bool ShouldLoadNextTrack() const { return m_shouldLoadNextTrack; }
     bool ShouldTogglePlayback() const { return m_shouldTogglePlayback; }
+    bool ShouldToggleLowLatency() const { return m_shouldToggleLowLatency; }
+    bool ShouldToggleMultiResolution() const { return m_shouldToggleMultiResolution; }
+    bool ShouldCycleBandLayout() const { return m_shouldCycleBandLayout; }
+    bool ShouldToggleBandWeighting() const { return m_shouldToggleBandWeighting; }
+    bool ShouldCycleWindow() const { return m_shouldCycleWindow; }
     bool ShouldExit() const { return m_shouldExit; }
 
     //  Ʈ
     void SetAudioInfo(const std::string& filename, bool isPlaying, float duration, float currentTime);
-    void SetFFTInfo(int fftSize, float maxFrequency);
+    void SetFFTInfo(int fftSize, float maxFrequency, const std::string& label = "FFT Size");
     void ResetFlags();
 
     // Ű Է ó
@@ -35,7 +41,13 @@ private:
 
     // GUI 
     bool m_shouldLoadFile;
+    bool m_shouldLoadNextTrack;
     bool m_shouldTogglePlayback;
+    bool m_shouldToggleLowLatency;
+    bool m_shouldToggleMultiResolution;
+    bool m_shouldCycleBandLayout;
+    bool m_shouldToggleBandWeighting;
+    bool m_shouldCycleWindow;
     bool m_shouldExit;
 
     //  
@@ -45,6 +57,7 @@ private:
     float m_currentTime;
     int m_fftSize;
     float m_maxFrequency;
+    std::string m_fftLabel;
 
     // ִϸ̼  Ű ó
     float m_time;
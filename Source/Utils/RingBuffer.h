@@ -0,0 +1,100 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// Fixed-size single-producer / single-consumer ring buffer. The producer only moves
+// the write index and the consumer only moves the read index, so neither side takes
+// a lock. Capacity is rounded up to a power of two; indices run freely and are masked
+// on access.
+template <typename T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(size_t capacity = 0)
+        : m_mask(0), m_readIndex(0), m_writeIndex(0)
+    {
+        Resize(capacity);
+    }
+
+    // Not thread safe: only call while neither side is running
+    void Resize(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+
+        m_buffer.assign(size, T());
+        m_mask = size - 1;
+        Reset();
+    }
+
+    void Reset()
+    {
+        m_readIndex.store(0, std::memory_order_relaxed);
+        m_writeIndex.store(0, std::memory_order_relaxed);
+    }
+
+    size_t GetCapacity() const { return m_buffer.size(); }
+
+    size_t GetReadAvailable() const
+    {
+        return m_writeIndex.load(std::memory_order_acquire) - m_readIndex.load(std::memory_order_relaxed);
+    }
+
+    size_t GetWriteAvailable() const
+    {
+        return m_buffer.size() - (m_writeIndex.load(std::memory_order_relaxed) - m_readIndex.load(std::memory_order_acquire));
+    }
+
+    // Producer side
+    size_t Write(const T* data, size_t count)
+    {
+        size_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+        size_t readIndex = m_readIndex.load(std::memory_order_acquire);
+        count = std::min(count, m_buffer.size() - (writeIndex - readIndex));
+
+        size_t start = writeIndex & m_mask;
+        size_t first = std::min(count, m_buffer.size() - start);
+        std::copy(data, data + first, m_buffer.begin() + start);
+        std::copy(data + first, data + count, m_buffer.begin());
+
+        m_writeIndex.store(writeIndex + count, std::memory_order_release);
+        return count;
+    }
+
+    size_t GetWriteIndex() const { return m_writeIndex.load(std::memory_order_acquire); }
+    size_t GetReadIndex() const { return m_readIndex.load(std::memory_order_relaxed); }
+
+    // Consumer side
+    size_t Read(T* data, size_t count)
+    {
+        size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+        size_t writeIndex = m_writeIndex.load(std::memory_order_acquire);
+        count = std::min(count, writeIndex - readIndex);
+
+        size_t start = readIndex & m_mask;
+        size_t first = std::min(count, m_buffer.size() - start);
+        std::copy(m_buffer.begin() + start, m_buffer.begin() + start + first, data);
+        std::copy(m_buffer.begin(), m_buffer.begin() + (count - first), data + first);
+
+        m_readIndex.store(readIndex + count, std::memory_order_release);
+        return count;
+    }
+
+    // Drops everything the producer had written up to 'writeIndex'
+    void DiscardUntil(size_t writeIndex)
+    {
+        size_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+        if (writeIndex - readIndex <= m_buffer.size())
+        {
+            m_readIndex.store(writeIndex, std::memory_order_release);
+        }
+    }
+
+private:
+    std::vector<T> m_buffer;
+    size_t m_mask;
+    std::atomic<size_t> m_readIndex;
+    std::atomic<size_t> m_writeIndex;
+};
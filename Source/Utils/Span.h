@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+// Non-owning view over a contiguous array, for APIs that write into caller-owned
+// buffers (std::span needs C++20)
+template <typename T>
+class Span
+{
+public:
+    Span() : m_data(nullptr), m_size(0) {}
+    Span(T* data, size_t size) : m_data(data), m_size(size) {}
+
+    template <typename U, typename Allocator, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    Span(std::vector<U, Allocator>& vector) : m_data(vector.data()), m_size(vector.size()) {}
+
+    template <typename U, typename Allocator, typename = std::enable_if_t<std::is_convertible_v<const U*, T*>>>
+    Span(const std::vector<U, Allocator>& vector) : m_data(vector.data()), m_size(vector.size()) {}
+
+    // Span<float> -> Span<const float>
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    Span(const Span<U>& other) : m_data(other.data()), m_size(other.size()) {}
+
+    T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    T& operator[](size_t index) const { return m_data[index]; }
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_size; }
+
+    Span subspan(size_t offset, size_t count) const
+    {
+        offset = offset < m_size ? offset : m_size;
+        return Span(m_data + offset, count < m_size - offset ? count : m_size - offset);
+    }
+
+private:
+    T* m_data;
+    size_t m_size;
+};
@@ -0,0 +1,123 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(size_t threadCount)
+    : m_stopping(false)
+{
+    if (threadCount == 0)
+    {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_tasks.push(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body)
+{
+    if (count == 0)
+        return;
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    size_t rangeCount = std::min((count + grainSize - 1) / grainSize, m_workers.size() + 1);
+    if (rangeCount <= 1)
+    {
+        body(0, count);
+        return;
+    }
+
+    struct Job
+    {
+        std::atomic<size_t> nextRange{ 0 };
+        std::atomic<size_t> finishedRanges{ 0 };
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    auto job = std::make_shared<Job>();
+    size_t rangeSize = (count + rangeCount - 1) / rangeCount;
+
+    // Helpers that start after all ranges are claimed return without touching 'body'
+    auto runRanges = [job, rangeCount, rangeSize, count, &body]()
+    {
+        for (size_t range = job->nextRange++; range < rangeCount; range = job->nextRange++)
+        {
+            size_t begin = range * rangeSize;
+            size_t end = std::min(begin + rangeSize, count);
+            if (begin < end)
+            {
+                body(begin, end);
+            }
+
+            if (++job->finishedRanges == rangeCount)
+            {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->finished.notify_all();
+            }
+        }
+    };
+
+    for (size_t i = 1; i < rangeCount; ++i)
+    {
+        Submit(runRanges);
+    }
+
+    runRanges();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&]() { return job->finishedRanges.load() == rangeCount; });
+}
+
+ThreadPool& ThreadPool::GetShared()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+
+            if (m_stopping && m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+
+        task();
+    }
+}
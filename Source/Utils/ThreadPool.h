@@ -0,0 +1,39 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for background and data-parallel work
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threadCount = 0); // 0 = one per hardware thread
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> task);
+
+    // Splits [0, count) into ranges of at least grainSize and runs body(begin, end) on
+    // the workers. The calling thread takes part and the call returns once every range
+    // is done, so it is safe to call from inside a worker.
+    void ParallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+
+    size_t GetThreadCount() const { return m_workers.size(); }
+
+    // Process-wide pool shared by the loaders and analysis stages
+    static ThreadPool& GetShared();
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stopping;
+};
@@ -1,6 +1,6 @@
 #include "GeometricPatterns.h"
 #include "../Graphics/ShapeGenerator.h"
-#include "../Audio/FrequencyAnalyzer.h"
+#include "../Audio/BandView.h"
 #include "../Utils/MathUtils.h"
 #include <cmath>
 #include <algorithm>
@@ -29,7 +29,7 @@ void GeometricPatterns::Initialize()
     m_shapes.reserve(32); // Reserve space for shapes
 }
 
-void GeometricPatterns::Update(const std::vector<FrequencyBand>& frequencyBands, float deltaTime)
+void GeometricPatterns::Update(const BandView& frequencyBands, float deltaTime)
 {
     m_time += deltaTime;
 
@@ -43,25 +43,25 @@ void GeometricPatterns::Update(const std::vector<FrequencyBand>& frequencyBands,
     size_t minSize = (m_shapes.size() < frequencyBands.size()) ? m_shapes.size() : frequencyBands.size();
     for (size_t i = 0; i < minSize; ++i)
     {
-        UpdateShapeFromFrequency(m_shapes[i], frequencyBands[i], deltaTime);
+        UpdateShapeFromFrequency(m_shapes[i], frequencyBands.frequencies[i], frequencyBands.smoothedAmplitudes[i], deltaTime);
     }
 }
 
-void GeometricPatterns::GeneratePatterns(const std::vector<FrequencyBand>& frequencyBands)
+void GeometricPatterns::GeneratePatterns(const BandView& frequencyBands)
 {
     m_shapes.clear();
     m_shapes.reserve(frequencyBands.size());
 
     for (size_t i = 0; i < frequencyBands.size(); ++i)
     {
-        const auto& band = frequencyBands[i];
+        const float frequency = frequencyBands.frequencies[i];
 
         PatternShape shape;
-        shape.type = GetShapeTypeFromFrequency(band.frequency);
-        shape.position = GetPositionFromFrequency(band.frequency, static_cast<int>(i));
+        shape.type = GetShapeTypeFromFrequency(frequency);
+        shape.position = GetPositionFromFrequency(frequency, static_cast<int>(i));
         shape.radius = 0.1f;
         shape.rotation = 0.0f;
-        shape.amplitude = band.smoothedAmplitude;
+        shape.amplitude = frequencyBands.smoothedAmplitudes[i];
         shape.color = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
         shape.active = true;
 
@@ -72,10 +72,10 @@ void GeometricPatterns::GeneratePatterns(const std::vector<FrequencyBand>& frequ
     }
 }
 
-void GeometricPatterns::UpdateShapeFromFrequency(PatternShape& shape, const FrequencyBand& band, float deltaTime)
+void GeometricPatterns::UpdateShapeFromFrequency(PatternShape& shape, float frequency, float smoothedAmplitude, float deltaTime)
 {
     // Update amplitude with smoothing
-    float targetAmplitude = band.smoothedAmplitude;
+    float targetAmplitude = smoothedAmplitude;
     shape.amplitude = MathUtils::Lerp(shape.amplitude, targetAmplitude, deltaTime * 10.0f);
 
     // Update radius based on amplitude
@@ -83,11 +83,11 @@ void GeometricPatterns::UpdateShapeFromFrequency(PatternShape& shape, const Freq
 
     // Add frequency-based scaling
     float freqScale = 1.0f;
-    if (band.frequency < 100.0f)        // Sub-bass
+    if (frequency < 100.0f)             // Sub-bass
         freqScale = 1.5f;
-    else if (band.frequency < 250.0f)   // Bass
+    else if (frequency < 250.0f)        // Bass
         freqScale = 1.3f;
-    else if (band.frequency < 2000.0f)  // Mid
+    else if (frequency < 2000.0f)       // Mid
         freqScale = 1.0f;
     else                                // High
         freqScale = 0.8f;
@@ -108,7 +108,7 @@ void GeometricPatterns::UpdateShapeFromFrequency(PatternShape& shape, const Freq
 
         if (m_patternStyle == 1) // Circular arrangement
         {
-            float angle = m_time * 0.5f + band.frequency * 0.001f;
+            float angle = m_time * 0.5f + frequency * 0.001f;
             float distance = 0.6f + shape.amplitude * 0.2f;
             rotatedPos.x = cosf(angle) * distance;
             rotatedPos.y = sinf(angle) * distance;
@@ -8,7 +8,7 @@ using namespace DirectX;
 
 // Forward declarations
 class ShapeGenerator;
-struct FrequencyBand;
+struct BandView;
 struct Vertex;
 
 struct PatternShape
@@ -30,15 +30,15 @@ public:
     ~GeometricPatterns();
 
     void Initialize();
-    void Update(const std::vector<FrequencyBand>& frequencyBands, float deltaTime);
-    void GeneratePatterns(const std::vector<FrequencyBand>& frequencyBands);
+    void Update(const BandView& frequencyBands, float deltaTime);
+    void GeneratePatterns(const BandView& frequencyBands);
 
     const std::vector<PatternShape>& GetShapes() const { return m_shapes; }
 
     void SetPatternStyle(int style) { m_patternStyle = style; }
 
 private:
-    void UpdateShapeFromFrequency(PatternShape& shape, const FrequencyBand& band, float deltaTime);
+    void UpdateShapeFromFrequency(PatternShape& shape, float frequency, float smoothedAmplitude, float deltaTime);
     ShapeType GetShapeTypeFromFrequency(float frequency);
     XMFLOAT2 GetPositionFromFrequency(float frequency, int index);
 
@@ -3,14 +3,20 @@
 #include "../Graphics/ColorManager.h"
 #include "GeometricPatterns.h"
 #include "AnimationSystem.h"
-#include "../Audio/FrequencyAnalyzer.h"
+#include "../Audio/BandView.h"
+#include "../Audio/BeatTracker.h"
+#include "../Audio/LoudnessMeter.h"
 #include "../Utils/MathUtils.h"
 #include <algorithm>
+#include <cmath>
 
-// std::max ũ 浹 
+// std::max, std::min ũ 浹 
 #ifdef max
 #undef max
 #endif
+#ifdef min
+#undef min
+#endif
 
 VisualizationEngine::VisualizationEngine()
     : m_renderer(nullptr)
@@ -20,6 +26,8 @@ VisualizationEngine::VisualizationEngine()
     , m_bassLevel(0.0f)
     , m_midLevel(0.0f)
     , m_trebleLevel(0.0f)
+    , m_beatPulse(0.0f)
+    , m_loudness(0.0f)
 {
 }
 
@@ -50,7 +58,7 @@ bool VisualizationEngine::Initialize(Renderer* renderer)
     return true;
 }
 
-void VisualizationEngine::Update(const std::vector<FrequencyBand>& frequencyBands, float deltaTime)
+void VisualizationEngine::Update(const BandView& frequencyBands, const BeatInfo& beat, const LoudnessLevels& loudness, float deltaTime)
 {
     m_time += deltaTime;
 
@@ -63,14 +71,16 @@ void VisualizationEngine::Update(const std::vector<FrequencyBand>& frequencyBand
     float newMidLevel = 0.0f;
     float newTrebleLevel = 0.0f;
 
-    for (const auto& band : frequencyBands)
+    for (size_t i = 0; i < frequencyBands.size(); ++i)
     {
-        if (band.frequency < 250.0f)
-            newBassLevel = (newBassLevel > band.smoothedAmplitude) ? newBassLevel : band.smoothedAmplitude;
-        else if (band.frequency < 4000.0f)
-            newMidLevel = (newMidLevel > band.smoothedAmplitude) ? newMidLevel : band.smoothedAmplitude;
+        const float frequency = frequencyBands.frequencies[i];
+        const float amplitude = frequencyBands.smoothedAmplitudes[i];
+        if (frequency < 250.0f)
+            newBassLevel = (newBassLevel > amplitude) ? newBassLevel : amplitude;
+        else if (frequency < 4000.0f)
+            newMidLevel = (newMidLevel > amplitude) ? newMidLevel : amplitude;
         else
-            newTrebleLevel = (newTrebleLevel > band.smoothedAmplitude) ? newTrebleLevel : band.smoothedAmplitude;
+            newTrebleLevel = (newTrebleLevel > amplitude) ? newTrebleLevel : amplitude;
     }
 
     // Apply animation system for smooth transitions
@@ -78,6 +88,13 @@ void VisualizationEngine::Update(const std::vector<FrequencyBand>& frequencyBand
     m_midLevel = m_animationSystem->GetMidResponse(newMidLevel, deltaTime);
     m_trebleLevel = m_animationSystem->GetTrebleResponse(newTrebleLevel, deltaTime);
 
+    // Beat pulse from the phase, so it peaks on the beat even between analysis frames
+    m_beatPulse = beat.bpm > 0.0f ? beat.confidence * expf(-beat.phase * BeatPulseDecay) : 0.0f;
+
+    // Loudness steps every 100 ms, so ease towards it
+    float targetLoudness = MathUtils::Clamp((loudness.momentary - QuietLoudness) / (LoudLoudness - QuietLoudness), 0.0f, 1.0f);
+    m_loudness += (targetLoudness - m_loudness) * std::min(deltaTime * LoudnessSpeed, 1.0f);
+
     // Update background color
     UpdateBackground(frequencyBands);
 
@@ -90,18 +107,20 @@ void VisualizationEngine::Render()
     if (!m_renderer)
         return;
 
-    // Set background color
+    // Set background color (scaled by loudness and brightened on the beat, after
+    // smoothing so the flash stays sharp)
+    float brightness = GetLoudnessBrightness() * (1.0f + m_beatPulse * BeatBackgroundBoost);
     m_renderer->SetBackgroundColor(
-        m_currentBackgroundColor.x,
-        m_currentBackgroundColor.y,
-        m_currentBackgroundColor.z
+        std::min(m_currentBackgroundColor.x * brightness, 1.0f),
+        std::min(m_currentBackgroundColor.y * brightness, 1.0f),
+        std::min(m_currentBackgroundColor.z * brightness, 1.0f)
     );
 
     // Render shapes
     RenderShapes();
 }
 
-void VisualizationEngine::UpdateBackground(const std::vector<FrequencyBand>& frequencyBands)
+void VisualizationEngine::UpdateBackground(const BandView& frequencyBands)
 {
     // Get new background color from color manager
     XMFLOAT3 targetColor = m_colorManager->GetBackgroundColor(m_bassLevel, m_midLevel, m_trebleLevel);
@@ -122,6 +141,10 @@ void VisualizationEngine::RenderShapes()
 
         // Get shape color
         XMFLOAT4 shapeColor = m_colorManager->GetShapeColor(0.0f, shape.amplitude);
+        float brightness = GetLoudnessBrightness() * (1.0f + m_beatPulse * BeatShapeBoost);
+        shapeColor.x = std::min(shapeColor.x * brightness, 1.0f);
+        shapeColor.y = std::min(shapeColor.y * brightness, 1.0f);
+        shapeColor.z = std::min(shapeColor.z * brightness, 1.0f);
 
         // Render shape as line strip (for outline)
         m_renderer->DrawLineStrip(shape.vertices, shapeColor);
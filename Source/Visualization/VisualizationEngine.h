@@ -10,7 +10,9 @@ class Renderer;
 class ColorManager;
 class GeometricPatterns;
 class AnimationSystem;
-struct FrequencyBand;
+struct BandView;
+struct BeatInfo;
+struct LoudnessLevels;
 
 enum class ColorMode;
 
@@ -21,7 +23,7 @@ public:
     ~VisualizationEngine();
 
     bool Initialize(Renderer* renderer);
-    void Update(const std::vector<FrequencyBand>& frequencyBands, float deltaTime);
+    void Update(const BandView& frequencyBands, const BeatInfo& beat, const LoudnessLevels& loudness, float deltaTime);
     void Render();
     void Shutdown();
 
@@ -31,8 +33,9 @@ public:
     void NextVisualizationMode();
 
 private:
-    void UpdateBackground(const std::vector<FrequencyBand>& frequencyBands);
+    void UpdateBackground(const BandView& frequencyBands);
     void RenderShapes();
+    float GetLoudnessBrightness() const { return LoudnessFloor + (1.0f - LoudnessFloor) * m_loudness; }
 
     Renderer* m_renderer;
     std::unique_ptr<ColorManager> m_colorManager;
@@ -47,4 +50,18 @@ private:
     float m_bassLevel;
     float m_midLevel;
     float m_trebleLevel;
+
+    // Flash on each tracked beat, fading over the beat; scaled by the tracker's confidence
+    float m_beatPulse;
+    static constexpr float BeatPulseDecay = 6.0f;      // Per beat (phase 0 -> 1)
+    static constexpr float BeatBackgroundBoost = 0.5f; // Background brightness at a full pulse
+    static constexpr float BeatShapeBoost = 0.6f;      // Shape brightness at a full pulse
+
+    // Absolute loudness (momentary LUFS mapped to 0 - 1): the spectrum is normalised per
+    // frame, so this is what keeps a quiet passage dimmer than a drop
+    float m_loudness;
+    static constexpr float QuietLoudness = -40.0f;  // LUFS shown at the floor
+    static constexpr float LoudLoudness = -8.0f;    // LUFS shown at full brightness
+    static constexpr float LoudnessFloor = 0.35f;   // Brightness of a quiet passage
+    static constexpr float LoudnessSpeed = 8.0f;    // Smoothing rate, per second
 };
\ No newline at end of file